@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include "indexed_heap.h"
+#include "pairing_heap.h"
+
+// Priority queue of (key, payload) with stable handles, for workloads that
+// reprioritize queued work (schedulers, event queues). push() hands back a
+// Handle that stays valid until its entry is extracted or removed, and is
+// what decreaseKey / increaseKey / remove take. Smaller keys come out first.
+//
+// Queue is any heap with the indexed_heap.h interface; handles are its
+// items, recycled through a free list so the index arrays stay dense.
+// Heaps made with sibling() share one handle space (and, for PairingHeap,
+// one node arena), so meld() moves entries across without touching handles:
+// O(1) for PairingHeap, O(m log n) for IndexedDaryHeap.
+template <class Payload, class Queue = IndexedDaryHeap<4>>
+class AddressableHeap {
+public:
+    using Handle = int;
+
+private:
+    struct Handles {
+        std::vector<Payload> payloads;
+        std::vector<Handle> freeList;
+    };
+
+    std::shared_ptr<Handles> handles;
+    Queue queue;
+
+    // Handles pushed into a sibling are past the end of this queue's index
+    // arrays (unless they are shared, as PairingHeap's arena is); grow them
+    // to the whole handle space before indexing by handle
+    void fit() { queue.reserveItems(handles->payloads.size()); }
+
+    Handle acquire(Payload payload) {
+        Handle h;
+        if (!handles->freeList.empty()) {
+            h = handles->freeList.back();
+            handles->freeList.pop_back();
+            handles->payloads[h] = std::move(payload);
+        } else {
+            h = static_cast<Handle>(handles->payloads.size());
+            handles->payloads.push_back(std::move(payload));
+        }
+        fit();
+        return h;
+    }
+
+    Payload release(Handle h) {
+        handles->freeList.push_back(h);
+        return std::move(handles->payloads[h]);
+    }
+
+public:
+    AddressableHeap() : handles(std::make_shared<Handles>()) {}
+
+    // An empty heap sharing this one's handles, so the two can meld
+    AddressableHeap sibling() const {
+        AddressableHeap h;
+        h.handles = handles;
+        h.queue = queue.sibling();
+        return h;
+    }
+
+    Handle push(int key, Payload payload) {
+        Handle h = acquire(std::move(payload));
+        queue.push(h, key);
+        return h;
+    }
+
+    bool empty() const { return queue.empty(); }
+    size_t size() const { return queue.size(); }
+
+    // Whether h is queued: in this heap for IndexedDaryHeap, in this heap or
+    // a sibling for PairingHeap (whose arena the siblings share)
+    bool contains(Handle h) const {
+        return h >= 0 && static_cast<size_t>(h) < handles->payloads.size() && queue.contains(h);
+    }
+
+    // h must be queued in this heap
+    int keyOf(Handle h) const { return queue.keyOf(h); }
+    const Payload& payload(Handle h) const { return handles->payloads[h]; }
+
+    Handle topHandle() const { return queue.top().item; }
+    int topKey() const { return queue.top().key; }
+
+    // Removes the smallest entry and returns its payload; the heap must not be empty
+    Payload extractRoot(int* key = nullptr) {
+        HeapEntry e = queue.pop();
+        if (key) *key = e.key;
+        return release(e.item);
+    }
+
+    void decreaseKey(Handle h, int key) {
+        fit();
+        queue.decreaseKey(h, key);
+    }
+
+    void increaseKey(Handle h, int key) {
+        fit();
+        queue.increaseKey(h, key);
+    }
+
+    // Either direction
+    void updateKey(Handle h, int key) {
+        if (key < keyOf(h)) decreaseKey(h, key);
+        else if (key > keyOf(h)) increaseKey(h, key);
+    }
+
+    // Takes h out wherever it is and returns its payload
+    Payload remove(Handle h) {
+        fit();
+        queue.remove(h);
+        return release(h);
+    }
+
+    // Moves all of other's entries in here. Only siblings share handles, so
+    // anything else is refused (returns false).
+    bool meld(AddressableHeap& other) {
+        if (other.handles != handles) return false;
+        fit();
+        queue.meld(other.queue);
+        return true;
+    }
+
+    // Drops this heap's entries (a sibling's are left alone)
+    void clear() {
+        queue.forEach([&](int item, int, int) { release(item); });
+        queue.clear();
+    }
+
+    // The underlying queue, for drawing its shape
+    const Queue& items() const { return queue; }
+};
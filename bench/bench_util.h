@@ -0,0 +1,103 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+// Shared input generators for the benchmark suite. Everything is seeded so
+// runs are comparable across builds.
+
+// Standard sizes: 1e3 .. 1e7
+#define VISUALGO_SIZES RangeMultiplier(10)->Range(1000, 10000000)
+
+inline std::vector<int> randomKeys(size_t n, unsigned seed = 42) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> dist(0, std::numeric_limits<int>::max());
+    std::vector<int> keys(n);
+    for (auto& k : keys) k = dist(rng);
+    return keys;
+}
+
+// count indices in [0, n) drawn from a Zipf distribution with exponent s:
+// index i comes up with probability proportional to 1 / (i + 1)^s, so a few
+// hot entries take most of the traffic
+inline std::vector<size_t> zipfIndices(size_t count, size_t n, double s = 0.99, unsigned seed = 13) {
+    std::vector<double> cdf(n);
+    double sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), s);
+        cdf[i] = sum;
+    }
+
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(0, sum);
+    std::vector<size_t> out(count);
+    for (auto& idx : out) {
+        idx = static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), dist(rng)) - cdf.begin());
+        if (idx == n) idx = n - 1;
+    }
+    return out;
+}
+
+inline std::vector<size_t> uniformIndices(size_t count, size_t n, unsigned seed = 13) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> dist(0, n - 1);
+    std::vector<size_t> out(count);
+    for (auto& idx : out) idx = dist(rng);
+    return out;
+}
+
+struct EdgeSpec {
+    int source;
+    int target;
+    int weight;
+};
+
+// Connected random graph with `edges` undirected edges over edges/4 vertices:
+// a random spanning tree plus uniformly random extra edges.
+inline std::vector<EdgeSpec> randomGraphEdges(size_t edges, unsigned seed = 7) {
+    int n = static_cast<int>(edges / 4 > 1 ? edges / 4 : 2);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> weight(1, 100);
+
+    std::vector<EdgeSpec> out;
+    out.reserve(edges);
+    for (int v = 1; v < n; v++) {
+        int u = std::uniform_int_distribution<int>(0, v - 1)(rng);
+        out.push_back({u, v, weight(rng)});
+    }
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    while (out.size() < edges) {
+        int u = vertex(rng), v = vertex(rng);
+        if (u != v) out.push_back({u, v, weight(rng)});
+    }
+    return out;
+}
+
+// side x side 4-connected grid with weights in [10, 20]. Vertex v sits at
+// (v % side, v / side), so every weight is at least 10x its length and a
+// straight-line heuristic is informative.
+inline std::vector<EdgeSpec> gridGraphEdges(int side, unsigned seed = 11) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> weight(10, 20);
+
+    std::vector<EdgeSpec> out;
+    out.reserve(2 * static_cast<size_t>(side) * side);
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            int v = y * side + x;
+            if (x + 1 < side) out.push_back({v, v + 1, weight(rng)});
+            if (y + 1 < side) out.push_back({v, v + side, weight(rng)});
+        }
+    }
+    return out;
+}
+
+inline std::vector<int> toTriplets(const std::vector<EdgeSpec>& edges) {
+    std::vector<int> triplets;
+    triplets.reserve(3 * edges.size());
+    for (const auto& e : edges) triplets.insert(triplets.end(), {e.source, e.target, e.weight});
+    return triplets;
+}
@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include <map>
+#include <memory>
+#include "graph_core.h"
+#include "pairing_heap.h"
+#include "bench_util.h"
+
+// Graphs are expensive to build, so each size is built once and shared
+template <class Queue = IndexedDaryHeap<4>>
+static Graph<NoTrace, Queue>& cachedGraph(size_t edges) {
+    static std::map<size_t, std::unique_ptr<Graph<NoTrace, Queue>>> cache;
+    auto& g = cache[edges];
+    if (!g) {
+        g = std::make_unique<Graph<NoTrace, Queue>>();
+        for (const auto& e : randomGraphEdges(edges)) g->addEdge(e.source, e.target, e.weight);
+    }
+    return *g;
+}
+
+static void BM_GraphBuild(benchmark::State& state) {
+    auto edges = randomGraphEdges(state.range(0));
+    for (auto _ : state) {
+        Graph<NoTrace> g;
+        for (const auto& e : edges) g.addEdge(e.source, e.target, e.weight);
+        benchmark::DoNotOptimize(g.data().nodeCount());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+BENCHMARK(BM_GraphBuild)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphBuildBulk(benchmark::State& state) {
+    auto edges = randomGraphEdges(state.range(0));
+    std::vector<int> triplets;
+    for (const auto& e : edges) triplets.insert(triplets.end(), {e.source, e.target, e.weight});
+    for (auto _ : state) {
+        Graph<NoTrace> g;
+        g.addEdgesBulk(triplets.data(), edges.size());
+        benchmark::DoNotOptimize(g.data().nodeCount());
+    }
+    state.SetItemsProcessed(state.iterations() * edges.size());
+}
+BENCHMARK(BM_GraphBuildBulk)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphBFS(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(g.bfs(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphBFS)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphBFSLevels(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(g.bfsLevels(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphBFSLevels)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphDFS(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(g.dfs(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphDFS)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphPrim(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(g.prim(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphPrim)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphKruskal(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(g.minimumSpanningTree(0, MstMode::Kruskal));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphKruskal)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphBoruvka(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(g.minimumSpanningTree(0, MstMode::Boruvka));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphBoruvka)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphDijkstra(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    int target = static_cast<int>(state.range(0) / 4) - 1;
+    for (auto _ : state) benchmark::DoNotOptimize(g.dijkstra(0, target));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphDijkstra)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// Same Dijkstra / Prim on a pairing heap instead of the indexed 4-ary heap
+static void BM_GraphDijkstraPairing(benchmark::State& state) {
+    auto& g = cachedGraph<PairingHeap>(state.range(0));
+    int target = static_cast<int>(state.range(0) / 4) - 1;
+    for (auto _ : state) benchmark::DoNotOptimize(g.dijkstra(0, target));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphDijkstraPairing)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphPrimPairing(benchmark::State& state) {
+    auto& g = cachedGraph<PairingHeap>(state.range(0));
+    for (auto _ : state) benchmark::DoNotOptimize(g.prim(0));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphPrimPairing)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// Stepped runs (graph_stepper.h) driven 64 steps per call, against the
+// one-shot BFS / Dijkstra above: the cost of keeping the loop state between calls
+static void BM_GraphSteppedBFS(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    for (auto _ : state) {
+        g.startRun(StepAlgorithm::BFS, 0);
+        while (g.step(64) == RunStatus::Running) {}
+        benchmark::DoNotOptimize(g.run().order().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphSteppedBFS)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_GraphSteppedDijkstra(benchmark::State& state) {
+    Graph<NoTrace>& g = cachedGraph(state.range(0));
+    int target = static_cast<int>(state.range(0) / 4) - 1;
+    for (auto _ : state) {
+        g.startRun(StepAlgorithm::Dijkstra, 0, target);
+        while (g.step(64) == RunStatus::Running) {}
+        benchmark::DoNotOptimize(g.run().path().data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GraphSteppedDijkstra)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// One tick of the native force layout (force_layout.h) on a graph of
+// range / 4 nodes: Barnes-Hut charge, springs and integration. The layout
+// is reheated every time so it never cools mid-benchmark.
+static void BM_GraphLayoutTick(benchmark::State& state) {
+    Graph<NoTrace> g;
+    for (const auto& e : randomGraphEdges(state.range(0))) g.addEdge(e.source, e.target, e.weight);
+    g.startLayout(0, 0);
+    g.layoutTick(1); // places the nodes
+    for (auto _ : state) {
+        g.startLayout(0, 0);
+        benchmark::DoNotOptimize(g.layoutTick(1));
+    }
+    state.SetItemsProcessed(state.iterations() * g.data().nodeCount());
+}
+BENCHMARK(BM_GraphLayoutTick)->RangeMultiplier(10)->Range(4000, 400000)->Unit(benchmark::kMillisecond);
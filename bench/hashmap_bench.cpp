@@ -0,0 +1,159 @@
+#include <benchmark/benchmark.h>
+#include <type_traits>
+#include "hashmap_core.h"
+#include "swiss_table.h"
+#include "bench_util.h"
+
+// Table sized for a 0.5 load factor once all keys are in
+static int capacityFor(size_t n) {
+    return static_cast<int>(2 * n);
+}
+
+static void BM_HashMapInsert(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        LinearProbing<NoTrace> map(capacityFor(keys.size()));
+        for (int k : keys) benchmark::DoNotOptimize(map.insert(k));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashMapInsert)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_HashMapSearchHit(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    LinearProbing<NoTrace> map(capacityFor(keys.size()));
+    for (int k : keys) map.insert(k);
+    for (auto _ : state) {
+        for (int k : keys) benchmark::DoNotOptimize(map.search(k));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashMapSearchHit)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_HashMapSearchMiss(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    auto misses = randomKeys(state.range(0), 1234);
+    LinearProbing<NoTrace> map(capacityFor(keys.size()));
+    for (int k : keys) map.insert(k);
+    for (auto _ : state) {
+        for (int k : misses) benchmark::DoNotOptimize(map.search(k));
+    }
+    state.SetItemsProcessed(state.iterations() * misses.size());
+}
+BENCHMARK(BM_HashMapSearchMiss)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_HashMapDelete(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        LinearProbing<NoTrace> map(capacityFor(keys.size()));
+        for (int k : keys) map.insert(k);
+        state.ResumeTiming();
+
+        for (int k : keys) benchmark::DoNotOptimize(map.remove(k));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashMapDelete)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_HashMapInsertBulk(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        LinearProbing<NoTrace> map(capacityFor(keys.size()));
+        benchmark::DoNotOptimize(map.insertBulk(keys.data(), keys.size()));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashMapInsertBulk)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// Delete/insert cycles on a full-size table, then look everything up.
+// Tombstones used to pile up here until every probe ran the length of the table.
+static void BM_HashMapChurn(benchmark::State& state) {
+    size_t n = state.range(0);
+    auto keys = randomKeys(2 * n);
+    for (auto _ : state) {
+        state.PauseTiming();
+        LinearProbing<NoTrace> map(capacityFor(n));
+        for (size_t i = 0; i < n; i++) map.insert(keys[i]);
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < n; i++) {
+            map.remove(keys[i]);
+            map.insert(keys[n + i]);
+        }
+        for (size_t i = n; i < 2 * n; i++) benchmark::DoNotOptimize(map.search(keys[i]));
+    }
+    state.SetItemsProcessed(state.iterations() * 3 * n);
+}
+BENCHMARK(BM_HashMapChurn)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// Starts tiny and grows through every doubling
+static void BM_HashMapInsertGrow(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        LinearProbing<NoTrace> map(16);
+        for (int k : keys) benchmark::DoNotOptimize(map.insert(k));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashMapInsertGrow)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// --- Robin Hood vs Swiss table at high load ---
+// Both tables get 2^20 slots up front and are filled to range(0) percent, so
+// neither resizes. Robin Hood is allowed up to 95% load; the Swiss table
+// rehashes past 7/8, which 87% stays just under.
+static constexpr int HEAD_TO_HEAD_SLOTS = 1 << 20;
+
+template <class Map>
+static Map makeMap() {
+    if constexpr (std::is_same_v<Map, LinearProbing<NoTrace>>) {
+        return Map(HEAD_TO_HEAD_SLOTS, &nullHashMapSink, 0.95f);
+    } else {
+        return Map(HEAD_TO_HEAD_SLOTS);
+    }
+}
+
+static size_t keysForLoad(const benchmark::State& state) {
+    return static_cast<size_t>(HEAD_TO_HEAD_SLOTS) * state.range(0) / 100;
+}
+
+template <class Map>
+static void BM_LoadInsert(benchmark::State& state) {
+    auto keys = randomKeys(keysForLoad(state));
+    for (auto _ : state) {
+        Map map = makeMap<Map>();
+        for (int k : keys) benchmark::DoNotOptimize(map.insert(k));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <class Map>
+static void BM_LoadSearchHit(benchmark::State& state) {
+    auto keys = randomKeys(keysForLoad(state));
+    Map map = makeMap<Map>();
+    for (int k : keys) map.insert(k);
+    for (auto _ : state) {
+        for (int k : keys) benchmark::DoNotOptimize(map.contains(k));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <class Map>
+static void BM_LoadSearchMiss(benchmark::State& state) {
+    auto keys = randomKeys(keysForLoad(state));
+    auto misses = randomKeys(keys.size(), 1234);
+    Map map = makeMap<Map>();
+    for (int k : keys) map.insert(k);
+    for (auto _ : state) {
+        for (int k : misses) benchmark::DoNotOptimize(map.contains(k));
+    }
+    state.SetItemsProcessed(state.iterations() * misses.size());
+}
+
+#define VISUALGO_LOADS Arg(50)->Arg(75)->Arg(87)
+BENCHMARK_TEMPLATE(BM_LoadInsert, LinearProbing<NoTrace>)->VISUALGO_LOADS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadInsert, SwissTable<NoTrace>)->VISUALGO_LOADS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadSearchHit, LinearProbing<NoTrace>)->VISUALGO_LOADS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadSearchHit, SwissTable<NoTrace>)->VISUALGO_LOADS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadSearchMiss, LinearProbing<NoTrace>)->VISUALGO_LOADS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_LoadSearchMiss, SwissTable<NoTrace>)->VISUALGO_LOADS->Unit(benchmark::kMillisecond);
@@ -0,0 +1,150 @@
+#include <benchmark/benchmark.h>
+#include "heap_core.h"
+#include "addressable_heap.h"
+#include "bench_util.h"
+
+static void BM_HeapInsert(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        Heap<NoTrace> heap;
+        for (int k : keys) heap.insert(k);
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HeapInsert)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_HeapExtractRoot(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Heap<NoTrace> heap;
+        for (int k : keys) heap.insert(k);
+        state.ResumeTiming();
+
+        int root;
+        while (heap.extractRoot(&root)) benchmark::DoNotOptimize(root);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HeapExtractRoot)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_HeapToggleType(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    Heap<NoTrace> heap;
+    for (int k : keys) heap.insert(k);
+    bool minHeap = false;
+    for (auto _ : state) {
+        minHeap = !minHeap;
+        heap.setMinHeap(minHeap); // full heapify
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HeapToggleType)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+static void BM_HeapInsertBulk(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        Heap<NoTrace> heap;
+        heap.insertBulk(keys.data(), keys.size());
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HeapInsertBulk)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// --- Arity on large heaps ---
+// Same workloads through 2-, 4- and 8-ary layouts. Wider nodes halve (or
+// third) the depth and put a node's children in one cache line.
+#define VISUALGO_LARGE_SIZES RangeMultiplier(10)->Range(100000, 10000000)
+
+template <int Arity>
+static void BM_HeapArityInsert(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        Heap<NoTrace, Arity> heap;
+        for (int k : keys) heap.insert(k);
+        benchmark::DoNotOptimize(heap.top());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_HeapArityInsert, 2)->VISUALGO_LARGE_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_HeapArityInsert, 4)->VISUALGO_LARGE_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_HeapArityInsert, 8)->VISUALGO_LARGE_SIZES->Unit(benchmark::kMillisecond);
+
+template <int Arity>
+static void BM_HeapArityExtract(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        Heap<NoTrace, Arity> heap;
+        heap.insertBulk(keys.data(), keys.size());
+        state.ResumeTiming();
+
+        int root;
+        while (heap.extractRoot(&root)) benchmark::DoNotOptimize(root);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_HeapArityExtract, 2)->VISUALGO_LARGE_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_HeapArityExtract, 4)->VISUALGO_LARGE_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_HeapArityExtract, 8)->VISUALGO_LARGE_SIZES->Unit(benchmark::kMillisecond);
+
+// --- Addressable heaps ---
+// Scheduler-style churn: n queued tasks, then n rounds of reprioritizing a
+// random task (up or down) and running the next one, which is requeued.
+template <class Queue>
+static void BM_AddressableChurn(benchmark::State& state) {
+    size_t n = state.range(0);
+    auto keys = randomKeys(3 * n);
+    std::mt19937 rng(3);
+    std::vector<int> picks(n);
+    for (auto& p : picks) p = static_cast<int>(rng() % n);
+
+    for (auto _ : state) {
+        AddressableHeap<int, Queue> heap;
+        std::vector<int> handles(n);
+        for (size_t i = 0; i < n; i++) handles[i] = heap.push(keys[i], static_cast<int>(i));
+        for (size_t i = 0; i < n; i++) {
+            heap.updateKey(handles[picks[i]], keys[n + i]);
+            int task = heap.extractRoot();
+            handles[task] = heap.push(keys[2 * n + i], task);
+        }
+        benchmark::DoNotOptimize(heap.topKey());
+    }
+    state.SetItemsProcessed(state.iterations() * 3 * n);
+}
+BENCHMARK_TEMPLATE(BM_AddressableChurn, IndexedDaryHeap<4>)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AddressableChurn, PairingHeap)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+// Building two halves and melding them: a splice for PairingHeap siblings,
+// re-pushes for the array heap. Only the meld is timed; the iteration count
+// is fixed, since a splice is so fast the runner would otherwise rebuild the
+// halves (untimed) millions of times.
+template <class Queue>
+static void BM_AddressableMeld(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    size_t half = keys.size() / 2;
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            AddressableHeap<int, Queue> a;
+            auto b = a.sibling();
+            int last = -1;
+            for (size_t i = 0; i < half; i++) last = a.push(keys[i], 0);
+            for (size_t i = half; i < keys.size(); i++) b.push(keys[i], 0);
+            // b's index arrays were sized before a's pushes; looking up one
+            // of a's handles through b must not read past them
+            benchmark::DoNotOptimize(b.contains(last));
+            state.ResumeTiming();
+
+            a.meld(b);
+            benchmark::DoNotOptimize(a.topKey());
+            state.PauseTiming(); // not the teardown
+        }
+        state.ResumeTiming();
+    }
+}
+BENCHMARK_TEMPLATE(BM_AddressableMeld, IndexedDaryHeap<4>)->VISUALGO_SIZES->Iterations(5)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_AddressableMeld, PairingHeap)->VISUALGO_SIZES->Iterations(5)->Unit(benchmark::kMicrosecond);
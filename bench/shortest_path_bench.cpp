@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include "graph_core.h"
+#include "bench_util.h"
+
+// Dijkstra vs bidirectional vs A* on the same graphs and the same query
+// pairs. Random graphs get random coordinates (A* still has to be correct,
+// it just can't prune much); grids get their real coordinates.
+
+struct PathFixture {
+    Graph<NoTrace> graph;
+    std::vector<std::pair<int, int>> queries;
+};
+
+static const int QUERIES = 16;
+
+static void addQueries(PathFixture& f, int n, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    for (int i = 0; i < QUERIES; i++) f.queries.push_back({vertex(rng), vertex(rng)});
+}
+
+static PathFixture& randomFixture(size_t edges) {
+    static std::map<size_t, std::unique_ptr<PathFixture>> cache;
+    auto& f = cache[edges];
+    if (!f) {
+        f = std::make_unique<PathFixture>();
+        auto spec = randomGraphEdges(edges);
+        auto triplets = toTriplets(spec);
+        f->graph.addEdgesBulk(triplets.data(), spec.size());
+
+        int n = static_cast<int>(f->graph.data().nodeCount());
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> coord(0, 1000);
+        std::vector<int> ids(n);
+        std::vector<float> xy(2 * n);
+        for (int v = 0; v < n; v++) {
+            ids[v] = v;
+            xy[2 * v] = coord(rng);
+            xy[2 * v + 1] = coord(rng);
+        }
+        f->graph.setPositions(ids.data(), xy.data(), n);
+        addQueries(*f, n, 9);
+    }
+    return *f;
+}
+
+static PathFixture& gridFixture(size_t edges) {
+    static std::map<size_t, std::unique_ptr<PathFixture>> cache;
+    auto& f = cache[edges];
+    if (!f) {
+        f = std::make_unique<PathFixture>();
+        int side = std::max(2, static_cast<int>(std::sqrt(edges / 2.0)));
+        auto spec = gridGraphEdges(side);
+        auto triplets = toTriplets(spec);
+        f->graph.addEdgesBulk(triplets.data(), spec.size());
+
+        int n = side * side;
+        std::vector<int> ids(n);
+        std::vector<float> xy(2 * n);
+        for (int v = 0; v < n; v++) {
+            ids[v] = v;
+            xy[2 * v] = static_cast<float>(v % side);
+            xy[2 * v + 1] = static_cast<float>(v / side);
+        }
+        f->graph.setPositions(ids.data(), xy.data(), n);
+        addQueries(*f, n, 9);
+    }
+    return *f;
+}
+
+template <PathMode Mode>
+static void runQueries(benchmark::State& state, PathFixture& f) {
+    for (auto _ : state) {
+        for (auto [s, t] : f.queries) benchmark::DoNotOptimize(f.graph.shortestPath(s, t, Mode));
+    }
+    state.SetItemsProcessed(state.iterations() * QUERIES);
+}
+
+template <PathMode Mode>
+static void BM_PathRandom(benchmark::State& state) {
+    runQueries<Mode>(state, randomFixture(state.range(0)));
+}
+BENCHMARK(BM_PathRandom<PathMode::Dijkstra>)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathRandom<PathMode::Bidirectional>)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathRandom<PathMode::AStar>)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+
+template <PathMode Mode>
+static void BM_PathGrid(benchmark::State& state) {
+    runQueries<Mode>(state, gridFixture(state.range(0)));
+}
+BENCHMARK(BM_PathGrid<PathMode::Dijkstra>)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathGrid<PathMode::Bidirectional>)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathGrid<PathMode::AStar>)->VISUALGO_SIZES->Unit(benchmark::kMillisecond);
@@ -0,0 +1,376 @@
+#include <benchmark/benchmark.h>
+#include "tree_core.h"
+#include "red_black_tree.h"
+#include "treap.h"
+#include "splay_tree.h"
+#include "bplus_tree.h"
+#include "eytzinger_index.h"
+#include "persistent_tree.h"
+#include "tree_layout.h"
+#include "bench_util.h"
+
+// Second argument: 0 = plain BST, 1 = AVL
+#define TREE_ARGS ArgsProduct({benchmark::CreateRange(1000, 10000000, 10), {0, 1}})
+
+static void fill(BST<NoTrace>& tree, const std::vector<int>& keys, bool avl) {
+    tree.setAVL(avl);
+    for (int k : keys) tree.insert(k);
+}
+
+static void BM_TreeInsert(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        BST<NoTrace> tree;
+        fill(tree, keys, state.range(1));
+        benchmark::DoNotOptimize(tree.getRoot());
+        state.PauseTiming();
+        tree.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_TreeInsert)->TREE_ARGS->Unit(benchmark::kMillisecond);
+
+static void BM_TreeSearch(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    BST<NoTrace> tree;
+    fill(tree, keys, state.range(1));
+    for (auto _ : state) {
+        for (int k : keys) benchmark::DoNotOptimize(tree.search(k));
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_TreeSearch)->TREE_ARGS->Unit(benchmark::kMillisecond);
+
+static void BM_TreeDelete(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        BST<NoTrace> tree;
+        fill(tree, keys, state.range(1));
+        state.ResumeTiming();
+
+        for (int k : keys) tree.remove(k);
+        benchmark::DoNotOptimize(tree.getRoot());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_TreeDelete)->TREE_ARGS->Unit(benchmark::kMillisecond);
+
+// Cost of the tracing hooks themselves (null sink), AVL inserts
+template <class Trace>
+static void BM_AVLInsertTrace(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        BST<Trace> tree;
+        tree.setAVL(true);
+        for (int k : keys) tree.insert(k);
+        benchmark::DoNotOptimize(tree.getRoot());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK_TEMPLATE(BM_AVLInsertTrace, NoTrace)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AVLInsertTrace, CoarseTrace)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AVLInsertTrace, FullTrace)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_TreeInsertBulk(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    for (auto _ : state) {
+        BST<NoTrace> tree;
+        tree.setAVL(state.range(1));
+        tree.insertBulk(keys.data(), keys.size());
+        benchmark::DoNotOptimize(tree.getRoot());
+        state.PauseTiming();
+        tree.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_TreeInsertBulk)->TREE_ARGS->Unit(benchmark::kMillisecond);
+
+// Fill / clear cycles on one tree. Clear resets the node pool in O(1) and
+// the next fill reuses its slabs, so only the first cycle allocates.
+static void BM_TreeInsertClearCycles(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    BST<NoTrace> tree;
+    for (auto _ : state) {
+        for (int k : keys) tree.insert(k);
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.counters["pool_bytes"] = static_cast<double>(tree.reservedBytes());
+}
+BENCHMARK(BM_TreeInsertClearCycles)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Turning AVL on over an unbalanced tree: rebuild from the sorted keys vs
+// Day-Stout-Warren rotations in place. Both are O(n).
+static void BM_TreeRebalance(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    auto mode = static_cast<RebalanceMode>(state.range(1));
+    for (auto _ : state) {
+        state.PauseTiming();
+        BST<NoTrace> tree;
+        fill(tree, keys, false);
+        state.ResumeTiming();
+
+        tree.setAVL(true, mode);
+        benchmark::DoNotOptimize(tree.getRoot());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_TreeRebalance)->ArgsProduct({benchmark::CreateRange(1000, 1000000, 10), {0, 1}})->Unit(benchmark::kMillisecond);
+
+// Regression for deep trees: sorted keys into a plain BST make one
+// n-long chain, which used to overflow the stack in the recursive insert,
+// delete and traversals. Inserts append past the largest key, then the
+// chain is deleted from the root end.
+static void BM_TreeSortedChain(benchmark::State& state) {
+    int n = static_cast<int>(state.range(0));
+    BST<NoTrace> tree;
+    for (auto _ : state) {
+        for (int k = 0; k < n; k++) tree.insert(k);
+        benchmark::DoNotOptimize(tree.getRoot());
+        for (int k = 0; k < n; k++) tree.remove(k);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_TreeSortedChain)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Order statistics on an AVL tree of n random keys: one rank, one select and
+// one countRange per item, all O(log n) through the subtree sizes
+static void BM_TreeOrderStats(benchmark::State& state) {
+    size_t n = state.range(0);
+    auto keys = randomKeys(n);
+    auto picks = uniformIndices(10000, n);
+    BST<NoTrace> tree;
+    fill(tree, keys, true);
+    for (auto _ : state) {
+        for (size_t i : picks) {
+            benchmark::DoNotOptimize(tree.rank(keys[i]));
+            int key;
+            benchmark::DoNotOptimize(tree.select(i, key));
+            benchmark::DoNotOptimize(tree.countRange(keys[i], keys[i] + (1 << 20)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * picks.size());
+}
+BENCHMARK(BM_TreeOrderStats)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Range scans of about `width` keys each, collected into one reused buffer
+// (what tree.cpp hands to JS as a single Int32Array)
+static void BM_TreeRangeScan(benchmark::State& state) {
+    size_t n = state.range(0);
+    int width = static_cast<int>(state.range(1));
+    auto keys = randomKeys(n);
+    auto picks = uniformIndices(10000, n);
+    BST<NoTrace> tree;
+    fill(tree, keys, true);
+    // Random keys cover [0, INT_MAX] evenly, so this span holds ~width keys
+    int span = static_cast<int>(static_cast<double>(std::numeric_limits<int>::max()) / n * width);
+    std::vector<int> out;
+    size_t found = 0;
+    for (auto _ : state) {
+        for (size_t i : picks) {
+            out.clear();
+            int lo = keys[i];
+            tree.rangeScan(lo, lo > std::numeric_limits<int>::max() - span ? std::numeric_limits<int>::max() : lo + span, out);
+            found += out.size();
+        }
+    }
+    state.SetItemsProcessed(found);
+}
+BENCHMARK(BM_TreeRangeScan)->ArgsProduct({{10000, 1000000}, {10, 1000}})->Unit(benchmark::kMillisecond);
+
+// --- Engines under uniform and skewed access ---
+// Each iteration runs OPS operations on a tree of n random keys. Keys are
+// picked uniformly or Zipf-distributed (a few hot keys take most accesses).
+// writePercent of the operations are updates (remove a key and put it back,
+// counted as one op); the rest are searches.
+//
+// Counters: rotations/op over the timed operations, access_depth = mean depth
+// of the keys the workload touches (measured after the run, on the final
+// shape), and time/op.
+static constexpr size_t ENGINE_OPS = 200000;
+
+template <class Tree> static void prepare(Tree&) {}
+static void prepare(BST<NoTrace>& tree) { tree.setAVL(true); }
+
+// Helper to find a key's depth without disturbing the tree (no splaying)
+static int depthOf(const Node* node, int key) {
+    int depth = 0;
+    while (node && node->data != key) {
+        node = key < node->data ? node->left : node->right;
+        depth++;
+    }
+    return depth;
+}
+
+template <class Tree>
+static void BM_TreeEngine(benchmark::State& state) {
+    size_t n = state.range(0);
+    bool zipf = state.range(1);
+    int writePercent = static_cast<int>(state.range(2));
+
+    auto keys = randomKeys(n);
+    auto picks = zipf ? zipfIndices(ENGINE_OPS, n) : uniformIndices(ENGINE_OPS, n);
+
+    Tree tree;
+    prepare(tree);
+    for (int k : keys) tree.insert(k);
+
+    size_t rotationsBefore = tree.rotations();
+    for (auto _ : state) {
+        for (size_t i = 0; i < ENGINE_OPS; i++) {
+            int k = keys[picks[i]];
+            if (static_cast<int>(i % 100) < writePercent) {
+                tree.remove(k);
+                tree.insert(k);
+            } else {
+                benchmark::DoNotOptimize(tree.search(k));
+            }
+        }
+    }
+    size_t ops = state.iterations() * ENGINE_OPS;
+
+    double depthSum = 0;
+    for (size_t i = 0; i < ENGINE_OPS; i += 64) depthSum += depthOf(tree.getRoot(), keys[picks[i]]);
+
+    state.SetItemsProcessed(ops);
+    state.counters["rotations/op"] = static_cast<double>(tree.rotations() - rotationsBefore) / ops;
+    state.counters["access_depth"] = depthSum / ((ENGINE_OPS + 63) / 64);
+    state.counters["time/op"] = benchmark::Counter(static_cast<double>(ops),
+                                                   benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+#define ENGINE_ARGS ArgsProduct({{100000, 1000000}, {0, 1}, {10, 50}})->ArgNames({"n", "zipf", "write%"})
+BENCHMARK_TEMPLATE(BM_TreeEngine, BST<NoTrace>)->ENGINE_ARGS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TreeEngine, RedBlackTree<NoTrace>)->ENGINE_ARGS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TreeEngine, Treap<NoTrace>)->ENGINE_ARGS->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_TreeEngine, SplayTree<NoTrace>)->ENGINE_ARGS->Unit(benchmark::kMillisecond);
+
+// --- Ordered index layouts: AVL vs B+ tree vs static Eytzinger ---
+// Same keys in three layouts. AVL chases one pointer per level; the B+ tree
+// reads log_17(n) cache-line nodes with a SIMD rank in each; the static
+// Eytzinger index does the same with no pointers and its top levels packed
+// together. bytes/key is the memory each layout holds.
+template <class Index> static void loadSorted(Index& index, std::vector<int> keys) {
+    index.insertBulk(keys.data(), keys.size());
+}
+static void loadSorted(BST<NoTrace>& tree, std::vector<int> keys) {
+    tree.setAVL(true);
+    tree.insertBulk(keys.data(), keys.size());
+}
+template <int B> static void loadSorted(EytzingerIndex<B>& index, std::vector<int> keys) {
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    index.build(keys);
+}
+
+template <class Index> static bool lookup(Index& index, int key) { return index.search(key); }
+template <int B> static bool lookup(EytzingerIndex<B>& index, int key) { return index.contains(key); }
+
+template <class Index>
+static void BM_OrderedSearch(benchmark::State& state) {
+    size_t n = state.range(0);
+    auto keys = randomKeys(n);
+    auto picks = uniformIndices(ENGINE_OPS, n);
+
+    Index index;
+    loadSorted(index, keys);
+    for (auto _ : state) {
+        for (size_t i : picks) benchmark::DoNotOptimize(lookup(index, keys[i]));
+    }
+    state.SetItemsProcessed(state.iterations() * ENGINE_OPS);
+    state.counters["bytes/key"] = static_cast<double>(index.reservedBytes()) / n;
+}
+#define ORDERED_SIZES RangeMultiplier(10)->Range(10000, 10000000)
+BENCHMARK_TEMPLATE(BM_OrderedSearch, BST<NoTrace>)->ORDERED_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_OrderedSearch, BPlusTree<NoTrace, 16>)->ORDERED_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_OrderedSearch, BPlusTree<NoTrace, 32>)->ORDERED_SIZES->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_OrderedSearch, EytzingerIndex<16>)->ORDERED_SIZES->Unit(benchmark::kMillisecond);
+
+// Random inserts into an empty tree, then removing them all again: the
+// update side, where the B+ tree's in-node shifts compete with AVL rotations
+template <class Tree>
+static void BM_OrderedUpdate(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    Tree tree;
+    prepare(tree);
+    for (auto _ : state) {
+        for (int k : keys) tree.insert(k);
+        for (int k : keys) tree.remove(k);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size() * 2);
+}
+BENCHMARK_TEMPLATE(BM_OrderedUpdate, BST<NoTrace>)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_OrderedUpdate, BPlusTree<NoTrace, 16>)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_OrderedUpdate, BPlusTree<NoTrace, 32>)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+
+// Persistent AVL: n random inserts, each a version, then every version
+// checked out once. nodes/version is what history costs per edit (about
+// the depth); copy_ratio compares the arena with keeping a full copy of
+// every version.
+static void BM_PersistentTreeHistory(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    size_t nodes = 0, copies = 0;
+    for (auto _ : state) {
+        PersistentTree<NoTrace> tree;
+        tree.setAVL(true);
+        copies = 0;
+        for (int k : keys) {
+            tree.insert(k);
+            copies += tree.size();
+        }
+        for (int v = 0; v < tree.versionCount(); v++) tree.checkout(v);
+        benchmark::DoNotOptimize(tree.height());
+        nodes = tree.nodeSlots();
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.counters["nodes/version"] = static_cast<double>(nodes) / keys.size();
+    state.counters["copy_ratio"] = static_cast<double>(nodes) / copies;
+}
+BENCHMARK(BM_PersistentTreeHistory)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+// Feeds an engine's deltas to a TreeLayout, the way tree.cpp does
+class LayoutSink : public TreeSink {
+public:
+    TreeLayout layout{50, 70};
+
+    void onNodeAdded(int id, int value, int parentId, bool right) override { layout.add(id, parentId, right ? 1 : 0); }
+    void onNodeRemoved(int id) override { layout.remove(id); }
+    void onRotated(int pivotId, bool right) override { layout.rotate(pivotId, right); }
+    void onReset() override { layout.clear(); }
+};
+
+// Tree layout after every insert into an AVL tree of n keys (the insert is
+// timed too): 0 = incremental, only the touched spine is redone; 1 = the
+// whole tree laid out from scratch each time, what d3.tree() does per render
+static void BM_TreeLayoutPerInsert(benchmark::State& state) {
+    auto keys = randomKeys(state.range(0));
+    bool full = state.range(1);
+    for (auto _ : state) {
+        LayoutSink sink;
+        BST<CoarseTrace> tree(&sink);
+        tree.setAVL(true);
+        for (int k : keys) {
+            tree.insert(k);
+            if (full) {
+                TreeLayout fresh(50, 70);
+                struct Pending { const Node* node; int parentId; int side; };
+                std::vector<Pending> stack{{tree.getRoot(), -1, 0}};
+                while (!stack.empty()) {
+                    Pending p = stack.back();
+                    stack.pop_back();
+                    if (!p.node) continue;
+                    fresh.add(p.node->id, p.parentId, p.side);
+                    stack.push_back({p.node->right, p.node->id, 1});
+                    stack.push_back({p.node->left, p.node->id, 0});
+                }
+                benchmark::DoNotOptimize(fresh.update().size());
+            } else {
+                benchmark::DoNotOptimize(sink.layout.update().size());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_TreeLayoutPerInsert)->ArgsProduct({{1000, 10000}, {0, 1}})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include "graph_store.h"
+#include "parallel.h"
+
+// Direction-optimizing, level-synchronous BFS over a GraphStore.
+//
+// Each level is expanded either
+//   - top-down: every frontier vertex claims its unvisited neighbours, or
+//   - bottom-up: every unvisited vertex looks for any neighbour in the
+//     frontier and stops at the first one,
+// switching to bottom-up when the frontier's edges outnumber 1/ALPHA of the
+// edges still unexplored, and back once the frontier drops under n/BETA
+// vertices (Beamer et al.). Both steps fan out over the shared thread pool;
+// visited is an atomic bitmap, so a vertex is claimed by exactly one thread.
+//
+// Levels are exact; within a level, order and the parent picked depend on
+// thread timing.
+class FrontierBfs {
+private:
+    static constexpr size_t ALPHA = 14;
+    static constexpr size_t BETA = 24;
+    static constexpr size_t TOP_DOWN_GRAIN = 256;
+    static constexpr size_t BOTTOM_UP_GRAIN = 4096;
+
+    std::vector<int> levels;
+    std::vector<int> parents;
+    std::vector<int> reached; // by level
+    std::vector<int> frontier;
+    std::vector<int> next;
+    AtomicBits visited;
+    AtomicBits inFrontier;
+    std::mutex appendLock;
+
+    // Helper to merge a chunk's discoveries into the next frontier
+    void append(const std::vector<int>& found) {
+        if (found.empty()) return;
+        std::lock_guard<std::mutex> l(appendLock);
+        next.insert(next.end(), found.begin(), found.end());
+    }
+
+    void stepTopDown(const GraphStore& g, int depth) {
+        parallelFor(frontier.size(), [&](size_t begin, size_t end) {
+            std::vector<int> found;
+            for (size_t i = begin; i < end; i++) {
+                int u = frontier[i];
+                g.forEachEdge(u, [&](int v, int) {
+                    if (visited.test(v) || visited.testAndSet(v)) return;
+                    levels[v] = depth;
+                    parents[v] = u;
+                    found.push_back(v);
+                });
+            }
+            append(found);
+        }, TOP_DOWN_GRAIN);
+    }
+
+    void stepBottomUp(const GraphStore& g, int depth) {
+        int n = g.vertexCount();
+        inFrontier.reset(n);
+        for (int u : frontier) inFrontier.testAndSet(u);
+
+        parallelFor(n, [&](size_t begin, size_t end) {
+            std::vector<int> found;
+            for (size_t i = begin; i < end; i++) {
+                int v = static_cast<int>(i);
+                if (!g.alive(v) || visited.test(v)) continue;
+                g.anyEdge(v, [&](int u, int) {
+                    if (!inFrontier.test(u)) return false;
+                    visited.testAndSet(v);
+                    levels[v] = depth;
+                    parents[v] = u;
+                    found.push_back(v);
+                    return true;
+                });
+            }
+            append(found);
+        }, BOTTOM_UP_GRAIN);
+    }
+
+public:
+    // source is a dense index
+    void run(const GraphStore& g, int source) {
+        int n = g.vertexCount();
+        levels.assign(n, -1);
+        parents.assign(n, GraphStore::NONE);
+        visited.reset(n);
+        reached.clear();
+        frontier.assign(1, source);
+
+        visited.testAndSet(source);
+        levels[source] = 0;
+        parents[source] = source;
+
+        size_t unexplored = g.halfEdgeBound();
+        bool bottomUp = false;
+
+        for (int depth = 1; !frontier.empty(); depth++) {
+            reached.insert(reached.end(), frontier.begin(), frontier.end());
+
+            size_t frontierEdges = 0;
+            for (int u : frontier) frontierEdges += g.degreeBound(u);
+            unexplored -= std::min(unexplored, frontierEdges);
+
+            if (!bottomUp && frontierEdges > unexplored / ALPHA) {
+                bottomUp = true;
+            } else if (bottomUp && frontier.size() < static_cast<size_t>(n) / BETA) {
+                bottomUp = false;
+            }
+
+            next.clear();
+            if (bottomUp) stepBottomUp(g, depth);
+            else stepTopDown(g, depth);
+            frontier.swap(next);
+        }
+    }
+
+    // Reached vertices grouped by level, start first
+    const std::vector<int>& order() const { return reached; }
+    int level(int v) const { return levels[v]; }
+    int parent(int v) const { return parents[v]; }
+};
@@ -0,0 +1,609 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "trace.h"
+#include "node_pool.h"
+#include "key_search.h"
+
+// --- Multiway tree events ---
+// Multiway nodes don't map onto the binary deltas of TreeSink, so the B+ tree
+// (and the static EytzingerIndex) report the whole tree as flat records
+// instead. Default methods do nothing, so a plain BTreeSink is the no-op sink.
+class BTreeSink {
+public:
+    virtual ~BTreeSink() = default;
+
+    // Nodes parent-before-child, children in key order, `stride` ints each:
+    // [id, parentId, leaf, count, keys...], parentId -1 for the root and keys
+    // padded to the node width with KEY_PAD
+    virtual void onSnapshot(const std::vector<int>& records, int stride, const char* message) {}
+    // Node ids visited by a search, root first
+    virtual void onSearchPath(const std::vector<int>& path) {}
+};
+
+inline BTreeSink nullBTreeSink;
+
+// B+ tree with fixed-width nodes: every key lives in a leaf, inner nodes only
+// route, and the leaves are chained left to right for ordered scans. A node's
+// keys fill whole cache lines (16 ints = 64 bytes by default) and are searched
+// with one SIMD compare per 4 keys (key_search.h), so a lookup touches about
+// log_17(n) lines where the binary engines touch log_2(n) scattered nodes.
+//
+// Nodes live in two SlabPools (node_pool.h), one for leaves and one for inner
+// nodes, and refer to each other by tagged slot: inner = 2 * slot,
+// leaf = 2 * slot + 1. That ref doubles as the node's id for the viewer.
+//
+// Same insert / remove / search / insertBulk / clear API as the binary engines
+// in tree_core.h, so tree.cpp and the benchmarks can swap it in. Nothing
+// rotates; rotations() is always 0.
+template <class Trace, int NodeKeys = 16>
+class BPlusTree {
+    static_assert(NodeKeys >= 4 && NodeKeys % 4 == 0, "node width must be a multiple of 4 keys");
+
+public:
+    static constexpr int MIN_KEYS = NodeKeys / 2; // every node but the root
+    // Words per record in onSnapshot
+    static constexpr int RECORD_STRIDE = 4 + NodeKeys;
+
+private:
+    struct alignas(64) Leaf {
+        int keys[NodeKeys];
+        int count = 0;
+        int next = -1; // ref of the leaf to the right
+    };
+
+    struct alignas(64) Inner {
+        int keys[NodeKeys]; // keys[i] = smallest key under children[i + 1]
+        int count = 0;
+        int children[NodeKeys + 1];
+        int sizes[NodeKeys + 1]; // keys under children[i], for rank / select
+    };
+
+    SlabPool<Leaf> leaves;
+    SlabPool<Inner> inners;
+    int root = -1;
+    size_t keyCount = 0;
+    BTreeSink* sink;
+
+    // (inner ref, child index taken) from the root down
+    std::vector<std::pair<int, int>> path;
+
+    static bool isLeaf(int ref) { return ref & 1; }
+    Leaf* leafAt(int ref) { return leaves.at(ref >> 1); }
+    Inner* innerAt(int ref) { return inners.at(ref >> 1); }
+    int countOf(int ref) { return isLeaf(ref) ? leafAt(ref)->count : innerAt(ref)->count; }
+
+    // Keys under ref, from its own counts (O(NodeKeys), not a walk)
+    int subtreeSize(int ref) {
+        if (isLeaf(ref)) return leafAt(ref)->count;
+        Inner* inner = innerAt(ref);
+        int total = 0;
+        for (int c = 0; c <= inner->count; c++) total += inner->sizes[c];
+        return total;
+    }
+
+    int newLeaf() {
+        int slot;
+        Leaf* leaf = leaves.acquire(slot);
+        std::fill(leaf->keys, leaf->keys + NodeKeys, KEY_PAD);
+        return slot * 2 + 1;
+    }
+
+    int newInner() {
+        int slot;
+        Inner* inner = inners.acquire(slot);
+        std::fill(inner->keys, inner->keys + NodeKeys, KEY_PAD);
+        return slot * 2;
+    }
+
+    void release(int ref) {
+        if (isLeaf(ref)) leaves.release(ref >> 1);
+        else inners.release(ref >> 1);
+    }
+
+    // Helper to open a gap at pos in a count-long array
+    static void insertAt(int* a, int count, int pos, int value) {
+        std::copy_backward(a + pos, a + count, a + count + 1);
+        a[pos] = value;
+    }
+
+    // Helper to close the gap at pos; the freed tail slot goes back to fill
+    static void eraseAt(int* a, int count, int pos, int fill) {
+        std::copy(a + pos + 1, a + count, a + pos);
+        a[count - 1] = fill;
+    }
+
+    // Walks to the leaf that would hold value, recording the inner nodes on
+    // the way in path (and their ids in visited, for the search highlight)
+    int descend(int value, std::vector<int>* visited = nullptr) {
+        path.clear();
+        int ref = root;
+        while (!isLeaf(ref)) {
+            if (visited) visited->push_back(ref);
+            Inner* inner = innerAt(ref);
+            int i = countLessEq<NodeKeys>(inner->keys, inner->count, value);
+            path.push_back({ref, i});
+            ref = inner->children[i];
+        }
+        if (visited) visited->push_back(ref);
+        return ref;
+    }
+
+    // --- Insert ---
+
+    void insertKey(int value) {
+        if (root < 0) {
+            root = newLeaf();
+            leafAt(root)->keys[0] = value;
+            leafAt(root)->count = 1;
+            keyCount = 1;
+            return;
+        }
+
+        int ref = descend(value);
+        Leaf* leaf = leafAt(ref);
+        int pos = countLess<NodeKeys>(leaf->keys, value);
+        if (pos < leaf->count && leaf->keys[pos] == value) return; // Duplicate keys not allowed
+        keyCount++;
+        for (auto [inner, i] : path) innerAt(inner)->sizes[i]++;
+
+        if (leaf->count < NodeKeys) {
+            insertAt(leaf->keys, leaf->count++, pos, value);
+            return;
+        }
+
+        // Full: split the K + 1 keys into two leaves and push the right one's
+        // first key up as its separator
+        int all[NodeKeys + 1];
+        std::copy(leaf->keys, leaf->keys + NodeKeys, all);
+        insertAt(all, NodeKeys, pos, value);
+
+        int rightRef = newLeaf();
+        Leaf* right = leafAt(rightRef);
+        int leftCount = (NodeKeys + 1) / 2;
+        std::fill(leaf->keys, leaf->keys + NodeKeys, KEY_PAD);
+        std::copy(all, all + leftCount, leaf->keys);
+        std::copy(all + leftCount, all + NodeKeys + 1, right->keys);
+        leaf->count = leftCount;
+        right->count = NodeKeys + 1 - leftCount;
+        right->next = leaf->next;
+        leaf->next = rightRef;
+        if constexpr (Trace::full) notify("Split Leaf");
+
+        insertSeparator(right->keys[0], rightRef, right->count);
+    }
+
+    // Adds (sep, child) into the inner node on top of path, splitting upward
+    // as long as nodes are full; a split root grows the tree by a level.
+    // childSize keys of children[i] (already counted) moved into child.
+    void insertSeparator(int sep, int child, int childSize) {
+        while (!path.empty()) {
+            auto [ref, i] = path.back();
+            path.pop_back();
+            Inner* inner = innerAt(ref);
+            inner->sizes[i] -= childSize;
+
+            if (inner->count < NodeKeys) {
+                insertAt(inner->children, inner->count + 1, i + 1, child);
+                insertAt(inner->sizes, inner->count + 1, i + 1, childSize);
+                insertAt(inner->keys, inner->count++, i, sep);
+                return;
+            }
+
+            int keys[NodeKeys + 1];
+            int children[NodeKeys + 2];
+            int sizes[NodeKeys + 2];
+            std::copy(inner->keys, inner->keys + NodeKeys, keys);
+            std::copy(inner->children, inner->children + NodeKeys + 1, children);
+            std::copy(inner->sizes, inner->sizes + NodeKeys + 1, sizes);
+            insertAt(keys, NodeKeys, i, sep);
+            insertAt(children, NodeKeys + 1, i + 1, child);
+            insertAt(sizes, NodeKeys + 1, i + 1, childSize);
+
+            // The middle key moves up; it isn't kept in either half
+            int rightRef = newInner();
+            Inner* right = innerAt(rightRef);
+            int leftCount = (NodeKeys + 1) / 2;
+            int rightCount = NodeKeys - leftCount;
+            std::fill(inner->keys, inner->keys + NodeKeys, KEY_PAD);
+            std::copy(keys, keys + leftCount, inner->keys);
+            std::copy(children, children + leftCount + 1, inner->children);
+            std::copy(keys + leftCount + 1, keys + NodeKeys + 1, right->keys);
+            std::copy(children + leftCount + 1, children + NodeKeys + 2, right->children);
+            std::copy(sizes, sizes + leftCount + 1, inner->sizes);
+            std::copy(sizes + leftCount + 1, sizes + NodeKeys + 2, right->sizes);
+            inner->count = leftCount;
+            right->count = rightCount;
+            if constexpr (Trace::full) notify("Split Node");
+
+            sep = keys[leftCount];
+            child = rightRef;
+            childSize = subtreeSize(rightRef);
+        }
+
+        int top = newInner();
+        Inner* inner = innerAt(top);
+        inner->keys[0] = sep;
+        inner->count = 1;
+        inner->children[0] = root;
+        inner->children[1] = child;
+        inner->sizes[0] = static_cast<int>(keyCount) - childSize;
+        inner->sizes[1] = childSize;
+        root = top;
+    }
+
+    // --- Remove ---
+
+    void removeKey(int value) {
+        if (root < 0) return;
+        int ref = descend(value);
+        Leaf* leaf = leafAt(ref);
+        int pos = countLess<NodeKeys>(leaf->keys, value);
+        if (pos >= leaf->count || leaf->keys[pos] != value) return;
+
+        eraseAt(leaf->keys, leaf->count--, pos, KEY_PAD);
+        keyCount--;
+        for (auto [inner, i] : path) innerAt(inner)->sizes[i]--;
+
+        // Refill underfull nodes from a sibling, or merge with one and carry
+        // the lost separator up. Stale separators are harmless: they still
+        // split the keys correctly, so nothing above is touched otherwise.
+        while (!path.empty() && countOf(ref) < MIN_KEYS) {
+            auto [parentRef, i] = path.back();
+            path.pop_back();
+            if (isLeaf(ref)) fixLeaf(innerAt(parentRef), i);
+            else fixInner(innerAt(parentRef), i);
+            ref = parentRef;
+        }
+
+        if (isLeaf(root)) {
+            if (leafAt(root)->count == 0) {
+                release(root);
+                root = -1;
+            }
+        } else if (innerAt(root)->count == 0) {
+            // Last two children merged: the root steps down a level
+            int old = root;
+            root = innerAt(root)->children[0];
+            release(old);
+        }
+    }
+
+    // Helper to fold child i + 1 into child i after a merge and drop it
+    // with separator i
+    void dropChild(Inner* parent, int i) {
+        parent->sizes[i] += parent->sizes[i + 1];
+        eraseAt(parent->sizes, parent->count + 1, i + 1, 0);
+        eraseAt(parent->children, parent->count + 1, i + 1, -1);
+        eraseAt(parent->keys, parent->count--, i, KEY_PAD);
+    }
+
+    // parent->children[i] is a leaf one key short
+    void fixLeaf(Inner* parent, int i) {
+        Leaf* node = leafAt(parent->children[i]);
+        Leaf* left = i > 0 ? leafAt(parent->children[i - 1]) : nullptr;
+        Leaf* right = i < parent->count ? leafAt(parent->children[i + 1]) : nullptr;
+
+        if (left && left->count > MIN_KEYS) {
+            insertAt(node->keys, node->count++, 0, left->keys[--left->count]);
+            left->keys[left->count] = KEY_PAD;
+            parent->keys[i - 1] = node->keys[0];
+            parent->sizes[i - 1]--;
+            parent->sizes[i]++;
+            if constexpr (Trace::full) notify("Borrowed Key");
+        } else if (right && right->count > MIN_KEYS) {
+            node->keys[node->count++] = right->keys[0];
+            eraseAt(right->keys, right->count--, 0, KEY_PAD);
+            parent->keys[i] = right->keys[0];
+            parent->sizes[i + 1]--;
+            parent->sizes[i]++;
+            if constexpr (Trace::full) notify("Borrowed Key");
+        } else {
+            // Merge into the left one of the pair
+            if (!left) {
+                left = node;
+                node = right;
+                i++;
+            }
+            std::copy(node->keys, node->keys + node->count, left->keys + left->count);
+            left->count += node->count;
+            left->next = node->next;
+            release(parent->children[i]);
+            dropChild(parent, i - 1);
+            if constexpr (Trace::full) notify("Merged Leaves");
+        }
+    }
+
+    // parent->children[i] is an inner node one key short; keys rotate
+    // through the parent's separator
+    void fixInner(Inner* parent, int i) {
+        Inner* node = innerAt(parent->children[i]);
+        Inner* left = i > 0 ? innerAt(parent->children[i - 1]) : nullptr;
+        Inner* right = i < parent->count ? innerAt(parent->children[i + 1]) : nullptr;
+
+        if (left && left->count > MIN_KEYS) {
+            int moved = left->sizes[left->count];
+            parent->sizes[i - 1] -= moved;
+            parent->sizes[i] += moved;
+            insertAt(node->sizes, node->count + 1, 0, moved);
+            insertAt(node->children, node->count + 1, 0, left->children[left->count]);
+            insertAt(node->keys, node->count++, 0, parent->keys[i - 1]);
+            parent->keys[i - 1] = left->keys[--left->count];
+            left->keys[left->count] = KEY_PAD;
+            if constexpr (Trace::full) notify("Borrowed Key");
+        } else if (right && right->count > MIN_KEYS) {
+            int moved = right->sizes[0];
+            parent->sizes[i + 1] -= moved;
+            parent->sizes[i] += moved;
+            node->keys[node->count] = parent->keys[i];
+            node->sizes[node->count + 1] = moved;
+            node->children[++node->count] = right->children[0];
+            parent->keys[i] = right->keys[0];
+            eraseAt(right->sizes, right->count + 1, 0, 0);
+            eraseAt(right->children, right->count + 1, 0, -1);
+            eraseAt(right->keys, right->count--, 0, KEY_PAD);
+            if constexpr (Trace::full) notify("Borrowed Key");
+        } else {
+            if (!left) {
+                left = node;
+                node = right;
+                i++;
+            }
+            // The separator comes down between the two halves
+            left->keys[left->count] = parent->keys[i - 1];
+            std::copy(node->keys, node->keys + node->count, left->keys + left->count + 1);
+            std::copy(node->children, node->children + node->count + 1, left->children + left->count + 1);
+            std::copy(node->sizes, node->sizes + node->count + 1, left->sizes + left->count + 1);
+            left->count += 1 + node->count;
+            release(parent->children[i]);
+            dropChild(parent, i - 1);
+            if constexpr (Trace::full) notify("Merged Nodes");
+        }
+    }
+
+    // --- Bulk build ---
+
+    // Builds bottom-up from sorted keys in O(n). Each level is cut into as few
+    // nodes as fit and the items spread evenly over them, which keeps every
+    // node at MIN_KEYS or more.
+    void buildFrom(const std::vector<int>& sorted) {
+        resetNodes();
+        keyCount = sorted.size();
+        if (sorted.empty()) return;
+
+        // (ref, smallest key below) for the level being built
+        std::vector<std::pair<int, int>> level;
+        size_t n = sorted.size();
+        size_t groups = (n + NodeKeys - 1) / NodeKeys;
+        size_t at = 0;
+        int prev = -1;
+        for (size_t g = 0; g < groups; g++) {
+            size_t take = n / groups + (g < n % groups);
+            int ref = newLeaf();
+            Leaf* leaf = leafAt(ref);
+            std::copy(sorted.begin() + at, sorted.begin() + at + take, leaf->keys);
+            leaf->count = static_cast<int>(take);
+            if (prev >= 0) leafAt(prev)->next = ref;
+            level.push_back({ref, sorted[at]});
+            prev = ref;
+            at += take;
+        }
+
+        while (level.size() > 1) {
+            std::vector<std::pair<int, int>> up;
+            n = level.size();
+            groups = (n + NodeKeys) / (NodeKeys + 1);
+            at = 0;
+            for (size_t g = 0; g < groups; g++) {
+                size_t take = n / groups + (g < n % groups);
+                int ref = newInner();
+                Inner* inner = innerAt(ref);
+                for (size_t c = 0; c < take; c++) {
+                    inner->children[c] = level[at + c].first;
+                    inner->sizes[c] = subtreeSize(level[at + c].first);
+                    if (c > 0) inner->keys[c - 1] = level[at + c].second;
+                }
+                inner->count = static_cast<int>(take - 1);
+                up.push_back({ref, level[at].second});
+                at += take;
+            }
+            level.swap(up);
+        }
+        root = level[0].first;
+    }
+
+    void resetNodes() {
+        leaves.reset();
+        inners.reset();
+        root = -1;
+        keyCount = 0;
+    }
+
+    // Keys < value (or <= value with inclusive): the descent for value, adding
+    // up the children it passes on the left
+    size_t countBelow(int value, bool inclusive, std::vector<int>* visited = nullptr) {
+        if (root < 0) return 0;
+        size_t below = 0;
+        int ref = root;
+        while (!isLeaf(ref)) {
+            if (visited) visited->push_back(ref);
+            Inner* inner = innerAt(ref);
+            int i = countLessEq<NodeKeys>(inner->keys, inner->count, value);
+            for (int c = 0; c < i; c++) below += inner->sizes[c];
+            ref = inner->children[i];
+        }
+        if (visited) visited->push_back(ref);
+        Leaf* leaf = leafAt(ref);
+        return below + (inclusive ? countLessEq<NodeKeys>(leaf->keys, leaf->count, value)
+                                  : countLess<NodeKeys>(leaf->keys, value));
+    }
+
+    int leftmostLeaf() {
+        int ref = root;
+        while (ref >= 0 && !isLeaf(ref)) ref = innerAt(ref)->children[0];
+        return ref;
+    }
+
+    // Helper to hand the whole tree to the sink
+    void notify(const char* message) {
+        std::vector<int> records;
+        records.reserve((leaves.liveCount() + inners.liveCount()) * RECORD_STRIDE);
+        std::vector<std::pair<int, int>> stack; // (ref, parent ref)
+        if (root >= 0) stack.push_back({root, -1});
+        while (!stack.empty()) {
+            auto [ref, parentRef] = stack.back();
+            stack.pop_back();
+            const int* keys = isLeaf(ref) ? leafAt(ref)->keys : innerAt(ref)->keys;
+            int count = countOf(ref);
+            records.push_back(ref);
+            records.push_back(parentRef);
+            records.push_back(isLeaf(ref) ? 1 : 0);
+            records.push_back(count);
+            records.insert(records.end(), keys, keys + NodeKeys);
+            if (!isLeaf(ref)) {
+                // Last child first so they come out in key order
+                Inner* inner = innerAt(ref);
+                for (int c = count; c >= 0; c--) stack.push_back({inner->children[c], ref});
+            }
+        }
+        sink->onSnapshot(records, RECORD_STRIDE, message);
+    }
+
+public:
+    explicit BPlusTree(BTreeSink* s = &nullBTreeSink) : sink(s) {}
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    void insert(int value) {
+        insertKey(value);
+        if constexpr (Trace::coarse) notify("Tree Updated");
+    }
+
+    void remove(int value) {
+        removeKey(value);
+        if constexpr (Trace::coarse) notify("Tree Updated");
+    }
+
+    bool search(int value) {
+        if (root < 0) {
+            if constexpr (Trace::coarse) sink->onSearchPath({});
+            return false;
+        }
+        int ref;
+        if constexpr (Trace::coarse) {
+            std::vector<int> visited;
+            ref = descend(value, &visited);
+            sink->onSearchPath(visited);
+        } else {
+            ref = descend(value);
+        }
+        Leaf* leaf = leafAt(ref);
+        int pos = countLess<NodeKeys>(leaf->keys, value);
+        return pos < leaf->count && leaf->keys[pos] == value;
+    }
+
+    // Merges in n values and rebuilds in O(n), rendering once. Returns how
+    // many keys were new.
+    int insertBulk(const int* values, size_t n) {
+        std::vector<int> merged = keys();
+        size_t existing = merged.size();
+        merged.insert(merged.end(), values, values + n);
+        std::sort(merged.begin(), merged.end());
+        merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+        buildFrom(merged);
+
+        if constexpr (Trace::coarse) notify("Bulk Loaded");
+        return static_cast<int>(merged.size() - existing);
+    }
+
+    // O(1): the pools keep their slabs for the next fill
+    void clear() {
+        resetNodes();
+        if constexpr (Trace::coarse) notify("Tree Cleared");
+    }
+
+    // --- Order statistics ---
+    // Same calls as TreeBase. Inner nodes keep the key count under each
+    // child (kept off the keys' cache line), so rank, select and countRange
+    // are one descent each, O(log n); rangeScan is O(log n + matches).
+
+    size_t rank(int value) {
+        if constexpr (Trace::coarse) {
+            std::vector<int> visited;
+            size_t r = countBelow(value, false, &visited);
+            sink->onSearchPath(visited);
+            return r;
+        } else {
+            return countBelow(value, false);
+        }
+    }
+
+    bool select(size_t index, int& key) {
+        std::vector<int> visited;
+        if (index >= keyCount) {
+            if constexpr (Trace::coarse) sink->onSearchPath(visited);
+            return false;
+        }
+        int ref = root;
+        while (!isLeaf(ref)) {
+            if constexpr (Trace::coarse) visited.push_back(ref);
+            Inner* inner = innerAt(ref);
+            int c = 0;
+            while (index >= static_cast<size_t>(inner->sizes[c])) index -= inner->sizes[c++];
+            ref = inner->children[c];
+        }
+        if constexpr (Trace::coarse) {
+            visited.push_back(ref);
+            sink->onSearchPath(visited);
+        }
+        key = leafAt(ref)->keys[index];
+        return true;
+    }
+
+    size_t countRange(int lo, int hi) {
+        if (lo > hi) return 0;
+        return countBelow(hi, true) - countBelow(lo, false);
+    }
+
+    // Keys in [lo, hi] appended to out: one descent, then along the leaf chain
+    void rangeScan(int lo, int hi, std::vector<int>& out) {
+        if (root < 0 || lo > hi) return;
+        int ref = descend(lo);
+        int pos = countLess<NodeKeys>(leafAt(ref)->keys, lo);
+        for (; ref >= 0; ref = leafAt(ref)->next, pos = 0) {
+            Leaf* leaf = leafAt(ref);
+            for (; pos < leaf->count; pos++) {
+                if (leaf->keys[pos] > hi) return;
+                out.push_back(leaf->keys[pos]);
+            }
+        }
+    }
+
+    // All keys in order, read off the leaf chain
+    std::vector<int> keys() {
+        std::vector<int> out;
+        out.reserve(keyCount);
+        for (int ref = leftmostLeaf(); ref >= 0; ref = leafAt(ref)->next) {
+            Leaf* leaf = leafAt(ref);
+            out.insert(out.end(), leaf->keys, leaf->keys + leaf->count);
+        }
+        return out;
+    }
+
+    size_t size() const { return keyCount; }
+    int height() {
+        int levels = 0;
+        for (int ref = root; ref >= 0; ref = isLeaf(ref) ? -1 : innerAt(ref)->children[0]) levels++;
+        return levels;
+    }
+
+    // Same readout as TreeBase: live nodes, slots handed out since the last
+    // clear, bytes held by the pools, rotations (never any)
+    size_t liveNodes() const { return leaves.liveCount() + inners.liveCount(); }
+    size_t nodeSlots() const { return leaves.slotCount() + inners.slotCount(); }
+    size_t reservedBytes() const { return leaves.reservedBytes() + inners.reservedBytes(); }
+    size_t rotations() const { return 0; }
+};
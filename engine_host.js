@@ -0,0 +1,85 @@
+// Runs a page's engine in a worker (engine_worker.js) so heavy operations
+// never stall D3, and replays its events here once per animation frame
+// (see event_ring.js for the stream itself). The shared ring needs the page
+// to be cross-origin isolated (served with COOP: same-origin and COEP:
+// require-corp); anywhere else the events come over postMessage instead.
+//
+//   startEngine({ script, factory, callbacks, coalesce }) -> Promise<Module>
+//
+// script / factory name the engine's modularized build (wasm/graph.js,
+// createGraphModule), callbacks the page functions the engine calls back.
+// The resolved Module has one method per engine export; each returns a
+// Promise of the result, resolved in order with the events. The promise
+// rejects if the engine script or its .wasm fails to load.
+//
+// coalesce(fn, args) -> { stream, full } or null marks events that only
+// rebuild state: full snapshots replace a stream's state outright, the
+// others (deltas) patch it. When a frame's batch holds several, everything
+// before the stream's last full snapshot would be drawn and immediately
+// overwritten, so it is skipped. That is what lets the page catch up when
+// the renderer falls behind instead of replaying every stale frame.
+
+const ENGINE_RING_BYTES = 1 << 24;
+
+function startEngine({ script, factory, callbacks, coalesce }) {
+    const worker = new Worker("engine_worker.js");
+    const shared = typeof SharedArrayBuffer !== "undefined" && self.crossOriginIsolated;
+    const ring = shared ? EventRing.create(ENGINE_RING_BYTES) : new PostedRing(worker).listen();
+    worker.postMessage({ init: { script, factory, callbacks, buffer: shared ? ring.buffer : null } });
+
+    const replies = new Map();
+    let nextId = 0;
+    let ready, failed;
+    const loaded = new Promise((resolve, reject) => {
+        ready = resolve;
+        failed = reject;
+    });
+
+    function call(fn, args) {
+        const id = nextId++;
+        worker.postMessage({ id, fn, args });
+        return new Promise((resolve, reject) => replies.set(id, { resolve, reject }));
+    }
+
+    // Index of each stream's last full snapshot in the batch
+    function lastSnapshots(messages) {
+        const last = new Map();
+        messages.forEach((m, i) => {
+            const state = m.call && coalesce ? coalesce(m.call, m.args) : null;
+            if (state && state.full) last.set(state.stream, i);
+        });
+        return last;
+    }
+
+    function drain() {
+        requestAnimationFrame(drain);
+        const messages = ring.read().map(unpackMessage);
+        const last = lastSnapshots(messages);
+
+        messages.forEach((m, i) => {
+            if (m.call) {
+                const state = coalesce ? coalesce(m.call, m.args) : null;
+                if (state && i < (last.get(state.stream) ?? -1)) return;
+                try {
+                    self[m.call](...m.args);
+                } catch (err) {
+                    console.error(err);
+                }
+            } else if (m.ready) {
+                const module = {};
+                for (const name of m.ready) module[name] = (...args) => call(name, args);
+                ready(module);
+            } else if (m.reply === undefined) {
+                failed(new Error(m.error));
+            } else {
+                const pending = replies.get(m.reply);
+                replies.delete(m.reply);
+                if (m.error !== undefined) pending.reject(new Error(m.error));
+                else pending.resolve(m.value);
+            }
+        });
+    }
+    requestAnimationFrame(drain);
+
+    return loaded;
+}
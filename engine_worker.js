@@ -0,0 +1,72 @@
+// Worker side of engine_host.js: loads one page's engine (wasm/<page>.js)
+// and runs every call into it here, off the page's main thread.
+//
+// The engines report back through JS globals (val::global("handleEvent"),
+// "renderHeap", ...). Here those globals are stubs that pack the call and
+// its arguments into the event ring as { call, args }; the page replays them
+// on its real functions. Call results go through the same ring as
+// { reply, value }, so a page never sees a result before the events of the
+// call that produced it. An engine that fails to load sends { error } instead
+// of { ready }.
+importScripts("event_ring.js");
+
+let engine = null;
+let ring = null;
+
+function send(message) {
+    ring.write(packMessage(message));
+}
+
+function init({ script, factory, callbacks, buffer }) {
+    ring = buffer ? new EventRing(buffer) : new PostedRing(self);
+    for (const name of callbacks) {
+        self[name] = function (...args) {
+            send({ call: name, args });
+        };
+    }
+
+    function fail(err) {
+        console.error(err);
+        send({ error: String(err) });
+        ring.flush();
+    }
+
+    try {
+        importScripts(script);
+    } catch (err) {
+        fail(err);
+        return;
+    }
+    self[factory]({
+        // The module sits next to its .wasm, not next to this script
+        locateFile: (path) => script.slice(0, script.lastIndexOf("/") + 1) + path,
+        // The engines don't print on purpose; stdout would only be noise
+        // from a hot path, so drop it and keep stderr for real errors
+        print: () => {},
+        printErr: (text) => console.error("WASM stderr:", text)
+    }).then((instance) => {
+        engine = instance;
+        const exports = Object.keys(instance).filter((k) => typeof instance[k] === "function" && !k.startsWith("_"));
+        send({ ready: exports });
+        ring.flush();
+    }, fail);
+}
+
+self.onmessage = function (e) {
+    const { init: options, id, fn, args } = e.data;
+    if (options) {
+        init(options);
+        return;
+    }
+
+    let reply;
+    try {
+        const value = engine[fn](...args);
+        reply = { reply: id, value: value === undefined ? null : value };
+    } catch (err) {
+        console.error(err);
+        reply = { reply: id, error: String(err) };
+    }
+    send(reply);
+    ring.flush();
+};
@@ -0,0 +1,213 @@
+// Event stream from an engine worker (engine_worker.js) to its page
+// (engine_host.js). Loaded on both sides.
+//
+// The stream is a single-producer / single-consumer byte ring in a
+// SharedArrayBuffer: the worker appends, the page drains once per animation
+// frame, and neither side ever takes a lock. Head and tail are byte counts
+// that only grow (wrapping at 2^32) and live a cache line apart; each side
+// stores only its own with Atomics, and that store is what publishes the
+// bytes before it. A full ring blocks the worker (Atomics.wait) until the
+// page catches up, which is the backpressure: a slow renderer slows the
+// engine down instead of queueing without bound.
+//
+// Messages are split into chunks of at most half the ring, each a length
+// word (LAST_CHUNK set on the final one) plus the bytes padded to 4, so a
+// message of any size fits through a ring of any size.
+
+const RING_HEADER_BYTES = 128;
+const RING_HEAD = 0;  // in Int32 words
+const RING_TAIL = 16;
+const LAST_CHUNK = 1 << 30;
+
+class EventRing {
+    // buffer: RING_HEADER_BYTES of header, then a power-of-two number of bytes
+    constructor(buffer) {
+        this.buffer = buffer;
+        this.header = new Int32Array(buffer, 0, RING_HEADER_BYTES / 4);
+        this.data = new Uint8Array(buffer, RING_HEADER_BYTES);
+        this.words = new Int32Array(buffer, RING_HEADER_BYTES);
+        this.capacity = this.data.length;
+        this.mask = this.capacity - 1;
+        this.parts = []; // consumer: chunks of a message still being written
+    }
+
+    static create(capacityBytes) {
+        return new EventRing(new SharedArrayBuffer(RING_HEADER_BYTES + capacityBytes));
+    }
+
+    // Bytes written and not yet drained
+    used() {
+        return (Atomics.load(this.header, RING_HEAD) - Atomics.load(this.header, RING_TAIL)) >>> 0;
+    }
+
+    // --- Producer (worker) ---
+
+    // Appends one message (a Uint8Array), waiting for room as needed
+    write(bytes) {
+        const maxChunk = this.capacity / 2 - 4;
+        let offset = 0;
+        do {
+            const length = Math.min(maxChunk, bytes.length - offset);
+            const last = offset + length === bytes.length;
+            const size = 4 + ((length + 3) & ~3);
+            const head = this.header[RING_HEAD]; // only this side stores it
+
+            for (;;) {
+                const tail = Atomics.load(this.header, RING_TAIL);
+                if (this.capacity - ((head - tail) >>> 0) >= size) break;
+                // Timed, so a page that stopped draining can't wedge the worker silently forever
+                Atomics.wait(this.header, RING_TAIL, tail, 1000);
+            }
+
+            this.words[(head & this.mask) >> 2] = length | (last ? LAST_CHUNK : 0);
+            this.copyIn(head + 4, bytes.subarray(offset, offset + length));
+            Atomics.store(this.header, RING_HEAD, (head + size) | 0);
+            offset += length;
+        } while (offset < bytes.length);
+    }
+
+    flush() {} // every write is already visible
+
+    // --- Consumer (page) ---
+
+    // Every message completed so far, as plain (non-shared) Uint8Arrays
+    read() {
+        const messages = [];
+        const head = Atomics.load(this.header, RING_HEAD);
+        let tail = this.header[RING_TAIL];
+        while (tail !== head) {
+            const word = this.words[(tail & this.mask) >> 2];
+            const length = word & (LAST_CHUNK - 1);
+            this.parts.push(this.copyOut(tail + 4, length));
+            tail = (tail + 4 + ((length + 3) & ~3)) | 0;
+            if (word & LAST_CHUNK) {
+                messages.push(joinChunks(this.parts));
+                this.parts = [];
+            }
+        }
+        Atomics.store(this.header, RING_TAIL, tail);
+        Atomics.notify(this.header, RING_TAIL);
+        return messages;
+    }
+
+    // Helpers to copy across the wrap point
+    copyIn(pos, bytes) {
+        const at = pos & this.mask;
+        const first = Math.min(bytes.length, this.capacity - at);
+        this.data.set(bytes.subarray(0, first), at);
+        if (first < bytes.length) this.data.set(bytes.subarray(first), 0);
+    }
+
+    copyOut(pos, length) {
+        const out = new Uint8Array(length);
+        const at = pos & this.mask;
+        const first = Math.min(length, this.capacity - at);
+        out.set(this.data.subarray(at, at + first));
+        if (first < length) out.set(this.data.subarray(0, length - first), first);
+        return out;
+    }
+}
+
+// Same interface over postMessage, for pages served without cross-origin
+// isolation (no SharedArrayBuffer). Messages are batched until flush(),
+// which the worker calls after every call into the engine. There is no
+// backpressure here, but coalescing on the page still applies.
+class PostedRing {
+    constructor(port) {
+        this.port = port;
+        this.outbox = [];
+        this.inbox = [];
+    }
+
+    // Page side: collect batches as they arrive
+    listen() {
+        this.port.addEventListener("message", (e) => {
+            if (e.data.events) this.inbox.push(...e.data.events);
+        });
+        return this;
+    }
+
+    used() {
+        return this.inbox.length;
+    }
+
+    write(bytes) {
+        this.outbox.push(bytes);
+    }
+
+    flush() {
+        if (!this.outbox.length) return;
+        this.port.postMessage({ events: this.outbox }, this.outbox.map((b) => b.buffer));
+        this.outbox = [];
+    }
+
+    read() {
+        const messages = this.inbox;
+        this.inbox = [];
+        return messages;
+    }
+}
+
+function joinChunks(parts) {
+    if (parts.length === 1) return parts[0];
+    const out = new Uint8Array(parts.reduce((n, p) => n + p.length, 0));
+    let at = 0;
+    for (const p of parts) {
+        out.set(p, at);
+        at += p.length;
+    }
+    return out;
+}
+
+// --- Message encoding ---
+// A message is any JSON-able value, except that typed arrays (the snapshot
+// views over the WASM heap, mostly) may appear anywhere in it. Those are
+// copied out as raw bytes after the JSON and referenced by index, so
+// snapshots never go through JSON and come back as typed arrays.
+//   [u32 jsonBytes] [json] (pad to 8) then per array:
+//   [u32 type] [u32 byteLength] [bytes] (pad to 8)
+
+const BLOB_TYPES = [Int32Array, Uint32Array, Float32Array, Float64Array, Uint8Array, Int8Array, Int16Array, Uint16Array];
+const pad8 = (n) => (n + 7) & ~7;
+
+function packMessage(value) {
+    const blobs = [];
+    const json = new TextEncoder().encode(JSON.stringify(value, (key, v) => {
+        if (!ArrayBuffer.isView(v)) return v;
+        blobs.push(v);
+        return { $blob: blobs.length - 1 };
+    }));
+
+    let size = pad8(4 + json.length);
+    for (const b of blobs) size += pad8(8 + b.byteLength);
+
+    const out = new Uint8Array(size);
+    const words = new DataView(out.buffer);
+    words.setUint32(0, json.length, true);
+    out.set(json, 4);
+    let at = pad8(4 + json.length);
+    for (const b of blobs) {
+        words.setUint32(at, BLOB_TYPES.findIndex((T) => b instanceof T), true);
+        words.setUint32(at + 4, b.byteLength, true);
+        out.set(new Uint8Array(b.buffer, b.byteOffset, b.byteLength), at + 8);
+        at += pad8(8 + b.byteLength);
+    }
+    return out;
+}
+
+// bytes must start at offset 0 of its own buffer (read() guarantees it);
+// the typed arrays come back as views into it
+function unpackMessage(bytes) {
+    const words = new DataView(bytes.buffer, bytes.byteOffset);
+    const jsonBytes = words.getUint32(0, true);
+    const blobs = [];
+    let at = pad8(4 + jsonBytes);
+    while (at < bytes.length) {
+        const T = BLOB_TYPES[words.getUint32(at, true)];
+        const byteLength = words.getUint32(at + 4, true);
+        blobs.push(new T(bytes.buffer, bytes.byteOffset + at + 8, byteLength / T.BYTES_PER_ELEMENT));
+        at += pad8(8 + byteLength);
+    }
+    const json = new TextDecoder().decode(bytes.subarray(4, 4 + jsonBytes));
+    return JSON.parse(json, (key, v) => (v && typeof v === "object" && "$blob" in v ? blobs[v.$blob] : v));
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include "key_search.h"
+
+// Read-only ordered index over a snapshot of sorted keys: a static B-tree
+// laid out implicitly in Eytzinger (BFS) order. Blocks of Block keys are one
+// cache line each; block k's children are blocks k * (Block + 1) + 1 + i, so
+// there are no pointers at all and the top levels, which every lookup walks,
+// sit next to each other at the front of the array.
+//
+// Built in O(n) from sorted keys. A lookup reads log_(Block+1)(n) lines with
+// one SIMD rank per block (key_search.h) and never branches on a key
+// comparison. The price is that it can't change: rebuild it from the live
+// tree's keys() to take a new snapshot.
+template <int Block = 16>
+class EytzingerIndex {
+    static_assert(Block % 4 == 0, "blocks are compared 4 keys at a time");
+
+public:
+    // Same record layout as BPlusTree's snapshots, so one viewer draws both
+    static constexpr int RECORD_STRIDE = 4 + Block;
+
+private:
+    struct alignas(64) Keys {
+        int keys[Block];
+    };
+
+    std::vector<Keys> blocks;
+    size_t keyCount = 0;
+    bool hasPadKey = false; // KEY_PAD doubles as padding, so it is tracked apart
+
+    size_t child(size_t k, int i) const { return k * (Block + 1) + 1 + i; }
+
+    // In-order fill, so the unused slots are the in-order last ones and
+    // compare above every key. Recursion depth is the height: a few levels.
+    void fill(size_t k, const std::vector<int>& sorted, size_t& at) {
+        for (int i = 0; i <= Block; i++) {
+            size_t c = child(k, i);
+            if (c < blocks.size()) fill(c, sorted, at);
+            if (i < Block) blocks[k].keys[i] = at < sorted.size() ? sorted[at++] : KEY_PAD;
+        }
+    }
+
+public:
+    EytzingerIndex() = default;
+    explicit EytzingerIndex(const std::vector<int>& sorted) { build(sorted); }
+
+    // sorted must be ascending without duplicates (keys() of any engine)
+    void build(const std::vector<int>& sorted) {
+        keyCount = sorted.size();
+        hasPadKey = !sorted.empty() && sorted.back() == KEY_PAD;
+        blocks.assign((keyCount + Block - 1) / Block, Keys{});
+        size_t at = 0;
+        if (!blocks.empty()) fill(0, sorted, at);
+    }
+
+    // Smallest key >= value into out; false if there is none
+    bool lowerBound(int value, int& out) const {
+        const int* best = nullptr;
+        size_t k = 0;
+        while (k < blocks.size()) {
+            const int* keys = blocks[k].keys;
+            int i = countLess<Block>(keys, value);
+            if (i < Block) best = keys + i;
+            k = child(k, i);
+        }
+        if (!best || (*best == KEY_PAD && !hasPadKey)) return false;
+        out = *best;
+        return true;
+    }
+
+    // With visited, the block ids on the way are collected for the search highlight
+    bool contains(int value, std::vector<int>* visited = nullptr) const {
+        if (visited) {
+            for (size_t k = 0; k < blocks.size(); k = child(k, countLess<Block>(blocks[k].keys, value))) {
+                visited->push_back(static_cast<int>(k));
+            }
+        }
+        int found;
+        return lowerBound(value, found) && found == value;
+    }
+
+    size_t size() const { return keyCount; }
+    size_t blockCount() const { return blocks.size(); }
+    size_t reservedBytes() const { return blocks.capacity() * sizeof(Keys); }
+
+    // Blocks as [id, parentId, leaf, count, keys...] records in block order
+    // (parents first). count skips the padding, so a stored KEY_PAD key is
+    // drawn as padding too.
+    std::vector<int> records() const {
+        std::vector<int> out;
+        out.reserve(blocks.size() * RECORD_STRIDE);
+        for (size_t k = 0; k < blocks.size(); k++) {
+            const int* keys = blocks[k].keys;
+            out.push_back(static_cast<int>(k));
+            out.push_back(k == 0 ? -1 : static_cast<int>((k - 1) / (Block + 1)));
+            out.push_back(child(k, 0) >= blocks.size() ? 1 : 0);
+            out.push_back(countLess<Block>(keys, KEY_PAD));
+            out.insert(out.end(), keys, keys + Block);
+        }
+        return out;
+    }
+};
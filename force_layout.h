@@ -0,0 +1,418 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "graph_store.h"
+#include "parallel.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// --- Many-body kernel ---
+// Pull of count point masses at (xs, ys) on a body at (x, y): the sums of
+// dx * m / d² and dy * m / d², with d² clamped to 1 (d3's distanceMin) so
+// near-coincident bodies don't blow up. A body's own entry has dx = dy = 0
+// and adds nothing. 4 masses per SIMD step (WASM SIMD128 or SSE2 when the
+// build has them; a plain loop the compiler can vectorize otherwise).
+inline void attraction(const float* xs, const float* ys, const float* ms, size_t count,
+                       float x, float y, float& sumX, float& sumY) {
+    size_t i = 0;
+    float sx = 0, sy = 0;
+#if defined(__wasm_simd128__)
+    v128_t px = wasm_f32x4_splat(x), py = wasm_f32x4_splat(y), one = wasm_f32x4_splat(1);
+    v128_t ax = wasm_f32x4_splat(0), ay = wasm_f32x4_splat(0);
+    for (; i + 4 <= count; i += 4) {
+        v128_t dx = wasm_f32x4_sub(wasm_v128_load(xs + i), px);
+        v128_t dy = wasm_f32x4_sub(wasm_v128_load(ys + i), py);
+        v128_t d2 = wasm_f32x4_max(wasm_f32x4_add(wasm_f32x4_mul(dx, dx), wasm_f32x4_mul(dy, dy)), one);
+        v128_t w = wasm_f32x4_div(wasm_v128_load(ms + i), d2);
+        ax = wasm_f32x4_add(ax, wasm_f32x4_mul(dx, w));
+        ay = wasm_f32x4_add(ay, wasm_f32x4_mul(dy, w));
+    }
+    sx = wasm_f32x4_extract_lane(ax, 0) + wasm_f32x4_extract_lane(ax, 1) +
+         wasm_f32x4_extract_lane(ax, 2) + wasm_f32x4_extract_lane(ax, 3);
+    sy = wasm_f32x4_extract_lane(ay, 0) + wasm_f32x4_extract_lane(ay, 1) +
+         wasm_f32x4_extract_lane(ay, 2) + wasm_f32x4_extract_lane(ay, 3);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 px = _mm_set1_ps(x), py = _mm_set1_ps(y), one = _mm_set1_ps(1);
+    __m128 ax = _mm_setzero_ps(), ay = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4) {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + i), px);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + i), py);
+        __m128 d2 = _mm_max_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), one);
+        __m128 w = _mm_div_ps(_mm_loadu_ps(ms + i), d2);
+        ax = _mm_add_ps(ax, _mm_mul_ps(dx, w));
+        ay = _mm_add_ps(ay, _mm_mul_ps(dy, w));
+    }
+    alignas(16) float lanes[4];
+    _mm_store_ps(lanes, ax);
+    sx = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    _mm_store_ps(lanes, ay);
+    sy = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; i < count; i++) {
+        float dx = xs[i] - x, dy = ys[i] - y;
+        float w = ms[i] / std::max(dx * dx + dy * dy, 1.0f);
+        sx += dx * w;
+        sy += dy * w;
+    }
+    sumX = sx;
+    sumY = sy;
+}
+
+// --- Force-directed layout ---
+// The same model as graph.html's d3.forceSimulation (link distance 100,
+// charge -300, centering, d3's alpha and velocity decay), so a graph that
+// grows past the page's threshold keeps the look it had. What changes is
+// the cost of the charge: instead of d3's quadtree in JS, a Barnes-Hut
+// quadtree here, with each body's far cells and near bodies gathered into
+// an interaction list and summed by attraction() above. Bodies are split
+// over the shared pool (parallel.h), which is just the calling thread in a
+// WASM build without pthreads.
+//
+// Positions live in the GraphStore (so A* sees them) and survive
+// compaction there. The layout only tracks which ids it has placed: new
+// nodes start next to a placed neighbor, or on d3's phyllotaxis spiral
+// around the center if they have none.
+class ForceLayout {
+private:
+    static constexpr float LINK_DISTANCE = 100;
+    static constexpr float CHARGE = -300;
+    static constexpr float THETA2 = 0.81f; // d3's default theta of 0.9, squared
+    static constexpr float VELOCITY_DECAY = 0.6f;
+    static constexpr float ALPHA_MIN = 0.001f;
+    static constexpr float ALPHA_DECAY = 0.0228f; // 1 - ALPHA_MIN^(1/300): 300 ticks to cool
+    static constexpr float DRAG_ALPHA = 0.3f;     // kept warm while a node is pinned
+    static constexpr int LEAF_SIZE = 8;
+    static constexpr int MAX_DEPTH = 24; // coincident bodies share a leaf instead of splitting forever
+
+    // Quadtree cell; a leaf (no children) holds bodies [first, first + count) of order
+    struct Cell {
+        float x, y; // center of mass
+        float mass;
+        float size; // side length
+        int first, count;
+        int children[4];
+    };
+
+    struct Link {
+        int source, target; // body indices
+        float strength, bias;
+    };
+
+    // Body i is dense vertex dense[i], node ids[i]
+    std::vector<int> ids;
+    std::vector<int> dense;
+    std::vector<int> bodyOf; // dense vertex -> body, -1 if dead
+    std::vector<float> px, py, vx, vy;
+    std::vector<float> packed; // [x, y] per body for the sink
+    std::vector<Link> links;
+
+    std::vector<Cell> cells;
+    std::vector<int> order; // bodies in quadtree order
+
+    std::unordered_set<int> placed;
+    std::unordered_map<int, std::pair<float, float>> pins;
+    float centerX = 0, centerY = 0;
+    float alphaValue = 1;
+    bool dirty = true;
+
+    int build(int lo, int hi, float x0, float y0, float size, int depth) {
+        int c = static_cast<int>(cells.size());
+        cells.push_back({0, 0, 0, size, lo, hi - lo, {-1, -1, -1, -1}});
+
+        if (hi - lo <= LEAF_SIZE || depth == MAX_DEPTH) {
+            float sx = 0, sy = 0;
+            for (int i = lo; i < hi; i++) {
+                sx += px[order[i]];
+                sy += py[order[i]];
+            }
+            float mass = static_cast<float>(hi - lo);
+            cells[c].x = sx / mass;
+            cells[c].y = sy / mass;
+            cells[c].mass = mass;
+            return c;
+        }
+
+        // Split into quadrants: top / bottom first, then left / right of each
+        float half = size / 2, mx = x0 + half, my = y0 + half;
+        auto split = [&](int from, int to, auto&& below) {
+            return static_cast<int>(std::partition(order.begin() + from, order.begin() + to, below) - order.begin());
+        };
+        int mid = split(lo, hi, [&](int b) { return py[b] < my; });
+        int bounds[5] = {lo, split(lo, mid, [&](int b) { return px[b] < mx; }), mid,
+                         split(mid, hi, [&](int b) { return px[b] < mx; }), hi};
+
+        float sx = 0, sy = 0, mass = 0;
+        for (int q = 0; q < 4; q++) {
+            if (bounds[q] == bounds[q + 1]) continue;
+            int child = build(bounds[q], bounds[q + 1], q & 1 ? mx : x0, q & 2 ? my : y0, half, depth + 1);
+            cells[c].children[q] = child;
+            sx += cells[child].x * cells[child].mass;
+            sy += cells[child].y * cells[child].mass;
+            mass += cells[child].mass;
+        }
+        cells[c].x = sx / mass;
+        cells[c].y = sy / mass;
+        cells[c].mass = mass;
+        return c;
+    }
+
+    void buildTree() {
+        cells.clear();
+        size_t n = ids.size();
+        order.resize(n);
+        for (size_t i = 0; i < n; i++) order[i] = static_cast<int>(i);
+        if (n == 0) return;
+
+        auto [minX, maxX] = std::minmax_element(px.begin(), px.end());
+        auto [minY, maxY] = std::minmax_element(py.begin(), py.end());
+        float size = std::max(*maxX - *minX, *maxY - *minY) + 1;
+        build(0, static_cast<int>(n), *minX, *minY, size, 0);
+    }
+
+    // Interaction list for one body: the far cells as point masses and the
+    // bodies of near leaves, for attraction()
+    struct Interactions {
+        std::vector<float> xs, ys, ms;
+        std::vector<int> stack;
+
+        void add(float x, float y, float m) {
+            xs.push_back(x);
+            ys.push_back(y);
+            ms.push_back(m);
+        }
+    };
+
+    void gather(int body, Interactions& list) const {
+        list.xs.clear();
+        list.ys.clear();
+        list.ms.clear();
+        list.stack.assign(1, 0);
+        float x = px[body], y = py[body];
+        while (!list.stack.empty()) {
+            const Cell& c = cells[list.stack.back()];
+            list.stack.pop_back();
+            float dx = c.x - x, dy = c.y - y;
+            if (c.size * c.size < THETA2 * (dx * dx + dy * dy)) {
+                list.add(c.x, c.y, c.mass);
+            } else if (c.children[0] < 0 && c.children[1] < 0 && c.children[2] < 0 && c.children[3] < 0) {
+                for (int i = c.first; i < c.first + c.count; i++) list.add(px[order[i]], py[order[i]], 1);
+            } else {
+                for (int child : c.children) {
+                    if (child >= 0) list.stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    void applyCharge(float alpha) {
+        buildTree();
+        float scale = CHARGE * alpha;
+        parallelFor(ids.size(), [&](size_t begin, size_t end) {
+            Interactions list;
+            for (size_t i = begin; i < end; i++) {
+                gather(static_cast<int>(i), list);
+                float fx, fy;
+                attraction(list.xs.data(), list.ys.data(), list.ms.data(), list.xs.size(), px[i], py[i], fx, fy);
+                vx[i] += fx * scale;
+                vy[i] += fy * scale;
+            }
+        }, 256);
+    }
+
+    // d3.forceLink: springs toward LINK_DISTANCE, weaker at busy nodes and
+    // moving the less connected end more
+    void applyLinks(float alpha) {
+        for (const Link& l : links) {
+            float dx = px[l.target] + vx[l.target] - px[l.source] - vx[l.source];
+            float dy = py[l.target] + vy[l.target] - py[l.source] - vy[l.source];
+            float len = std::sqrt(dx * dx + dy * dy);
+            if (len == 0) continue;
+            float k = (len - LINK_DISTANCE) / len * alpha * l.strength;
+            dx *= k;
+            dy *= k;
+            vx[l.target] -= dx * l.bias;
+            vy[l.target] -= dy * l.bias;
+            vx[l.source] += dx * (1 - l.bias);
+            vy[l.source] += dy * (1 - l.bias);
+        }
+    }
+
+    // d3.forceCenter: shifts everything so the mean sits on the center
+    void applyCenter() {
+        size_t n = ids.size();
+        if (n == 0) return;
+        float sx = 0, sy = 0;
+        for (size_t i = 0; i < n; i++) {
+            sx += px[i];
+            sy += py[i];
+        }
+        float shiftX = sx / n - centerX, shiftY = sy / n - centerY;
+        for (size_t i = 0; i < n; i++) {
+            px[i] -= shiftX;
+            py[i] -= shiftY;
+        }
+    }
+
+    void integrate(const GraphStore& store) {
+        for (size_t i = 0, n = ids.size(); i < n; i++) {
+            vx[i] *= VELOCITY_DECAY;
+            vy[i] *= VELOCITY_DECAY;
+            px[i] += vx[i];
+            py[i] += vy[i];
+        }
+        for (const auto& [id, at] : pins) {
+            int v = store.find(id);
+            if (v == GraphStore::NONE) continue;
+            int b = bodyOf[v];
+            px[b] = at.first;
+            py[b] = at.second;
+            vx[b] = vy[b] = 0;
+        }
+    }
+
+    // Puts a node that has never been laid out next to a placed neighbor,
+    // or on the spiral around the center; k spreads successive ones out
+    void place(const GraphStore& store, int v, int b, int k) {
+        const float golden = 3.14159265f * (3 - std::sqrt(5.0f));
+        float angle = k * golden;
+        int anchor = -1;
+        store.anyEdge(v, [&](int t, int) {
+            if (!placed.count(store.idOf(t))) return false;
+            anchor = t;
+            return true;
+        });
+        if (anchor >= 0) {
+            px[b] = store.x(anchor) + 30 * std::cos(angle);
+            py[b] = store.y(anchor) + 30 * std::sin(angle);
+        } else {
+            float r = 10 * std::sqrt(0.5f + k);
+            px[b] = centerX + r * std::cos(angle);
+            py[b] = centerY + r * std::sin(angle);
+        }
+    }
+
+public:
+    // Called on every structural change; the node set is re-read on the next tick
+    void invalidate(GraphChange change, int id) {
+        if (change == GraphChange::Cleared) {
+            placed.clear();
+            pins.clear();
+        } else if (change == GraphChange::NodeRemoved) {
+            placed.erase(id);
+            pins.erase(id);
+        }
+        dirty = true;
+        alphaValue = 1;
+    }
+
+    // Positions set from outside (the page's own layout) count as placed
+    void markPlaced(int id) { placed.insert(id); }
+
+    // Restarts the layout around (x, y)
+    void start(float x, float y) {
+        centerX = x;
+        centerY = y;
+        alphaValue = 1;
+    }
+
+    // Holds a node at (x, y) (a drag) and keeps the layout warm until released
+    void pin(int id, float x, float y) {
+        pins[id] = {x, y};
+        alphaValue = std::max(alphaValue, DRAG_ALPHA);
+    }
+
+    void release(int id) { pins.erase(id); }
+
+    // Re-reads the node set and links after a change; returns whether it did
+    bool sync(GraphStore& store) {
+        if (!dirty) return false;
+        dirty = false;
+
+        int count = store.vertexCount();
+        ids.clear();
+        dense.clear();
+        bodyOf.assign(count, -1);
+        for (int v = 0; v < count; v++) {
+            if (!store.alive(v)) continue;
+            bodyOf[v] = static_cast<int>(ids.size());
+            ids.push_back(store.idOf(v));
+            dense.push_back(v);
+        }
+
+        size_t n = ids.size();
+        px.resize(n);
+        py.resize(n);
+        vx.assign(n, 0);
+        vy.assign(n, 0);
+        int fresh = 0;
+        for (size_t b = 0; b < n; b++) {
+            int v = dense[b];
+            if (placed.count(ids[b])) {
+                px[b] = store.x(v);
+                py[b] = store.y(v);
+                continue;
+            }
+            place(store, v, static_cast<int>(b), fresh++);
+            store.setPosition(v, px[b], py[b]);
+            placed.insert(ids[b]);
+        }
+
+        // Each undirected edge once, from its lower end
+        std::vector<int> degree(n, 0);
+        links.clear();
+        for (size_t b = 0; b < n; b++) {
+            int v = dense[b];
+            store.forEachEdge(v, [&](int t, int) {
+                if (t <= v) return;
+                links.push_back({static_cast<int>(b), bodyOf[t], 0, 0});
+                degree[b]++;
+                degree[bodyOf[t]]++;
+            });
+        }
+        for (Link& l : links) {
+            float ds = static_cast<float>(degree[l.source]), dt = static_cast<float>(degree[l.target]);
+            l.strength = 1 / std::min(ds, dt);
+            l.bias = ds / (ds + dt);
+        }
+        return true;
+    }
+
+    // Runs up to ticks steps (none once cooled) and writes the positions
+    // back to the store; returns how many ran
+    int tick(GraphStore& store, int ticks) {
+        sync(store);
+        float target = pins.empty() ? 0 : DRAG_ALPHA;
+        int ran = 0;
+        for (; ran < ticks && (alphaValue >= ALPHA_MIN || target > 0); ran++) {
+            alphaValue += (target - alphaValue) * ALPHA_DECAY;
+            applyLinks(alphaValue);
+            applyCharge(alphaValue);
+            applyCenter();
+            integrate(store);
+        }
+        if (ran == 0) return 0;
+
+        packed.resize(2 * ids.size());
+        for (size_t b = 0; b < ids.size(); b++) {
+            store.setPosition(dense[b], px[b], py[b]);
+            packed[2 * b] = px[b];
+            packed[2 * b + 1] = py[b];
+        }
+        return ran;
+    }
+
+    bool cooled() const { return alphaValue < ALPHA_MIN && pins.empty(); }
+    float alpha() const { return alphaValue; }
+
+    // Node ids in body order, and [x, y] per body after the last tick
+    const std::vector<int>& nodeIds() const { return ids; }
+    const std::vector<float>& positions() const { return packed; }
+};
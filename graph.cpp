@@ -4,314 +4,241 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <queue>
-#include <stack>
-#include <map>
-#include <limits>
 #include <algorithm>
-#include <set>
+#include "graph_core.h"
+#include "snapshot.h"
 
 using namespace emscripten;
 
-struct Edge {
-    int target;
-    int weight;
-};
+// File-local up to the bindings (see tree.cpp)
+namespace {
+
+// --- Web bindings for the graph engine (logic lives in graph_core.h) ---
 
-// Adjacency List: node_id -> list of edges
-std::map<int, std::vector<Edge>> adj;
-std::set<int> nodes;
+SnapshotWriter graphSnapshot;
 
 // Helper to log events to JS
 void logEvent(std::string type, val data, std::string message) {
     val::global("handleEvent").call<void>("call", val::undefined(), type, data, message);
 }
 
-// Helper to get graph data for visualization
-val getGraphData() {
-    val nodesArray = val::array();
-    for (int id : nodes) {
-        val nodeObj = val::object();
-        nodeObj.set("id", id);
-        nodesArray.call<void>("push", nodeObj);
-    }
+// Helper to get graph data for visualization: a section of node ids and a
+// section of [source, target, weight] links, decoded by snapshot.js
+val getGraphData(const GraphStore& graph) {
+    graphSnapshot.begin(SNAPSHOT_GRAPH);
 
-    val linksArray = val::array();
-    for (auto const& [u, edges] : adj) {
-        for (const auto& edge : edges) {
-            val linkObj = val::object();
-            linkObj.set("source", u);
-            linkObj.set("target", edge.target);
-            linkObj.set("weight", edge.weight);
-            linksArray.call<void>("push", linkObj);
-        }
-    }
+    graphSnapshot.beginSection(1);
+    graph.forEachNode([](int id) { graphSnapshot.put(id); });
+    graphSnapshot.endSection();
 
-    val graphData = val::object();
-    graphData.set("nodes", nodesArray);
-    graphData.set("links", linksArray);
-    return graphData;
-}
+    graphSnapshot.beginSection(3);
+    graph.forEachLink([](int source, int target, int weight) {
+        graphSnapshot.put(source, target, weight);
+    });
+    graphSnapshot.endSection();
 
-void updateGraphVisualization(std::string message) {
-    logEvent("snapshot", getGraphData(), message);
+    return graphSnapshot.view();
 }
 
-extern "C" {
-
-void addNode(int id) {
-    if (nodes.find(id) == nodes.end()) {
-        nodes.insert(id);
-        updateGraphVisualization("Added Node " + std::to_string(id));
+std::string changeMessage(GraphChange change, int a, int b) {
+    switch (change) {
+        case GraphChange::NodeAdded: return "Added Node " + std::to_string(a);
+        case GraphChange::NodeRemoved: return "Removed Node " + std::to_string(a);
+        case GraphChange::EdgeAdded: return "Added Edge " + std::to_string(a) + "-" + std::to_string(b);
+        case GraphChange::EdgeRemoved: return "Removed Edge " + std::to_string(a) + "-" + std::to_string(b);
+        case GraphChange::Cleared: return "Graph Cleared";
+        case GraphChange::BulkLoaded: return "Loaded " + std::to_string(a) + " Edges";
     }
+    return "";
 }
 
-void addEdge(int source, int target, int weight) {
-    addNode(source);
-    addNode(target);
-    
-    // Check if edge exists to update weight or avoid duplicates (assuming directed for now, or undirected?)
-    // The prompt says "Add/remove nodes and edges". Let's assume directed for generality, or undirected?
-    // Most visualizers do directed or undirected. Let's do Directed for now, or maybe Undirected is better for MST?
-    // MST (Prim/Kruskal) usually on Undirected. Dijkstra on Directed/Undirected.
-    // Let's make it Undirected for MST compatibility, or support both?
-    // Let's stick to Undirected for simplicity with MST.
-    
-    // Remove existing if any
-    auto& edgesSource = adj[source];
-    edgesSource.erase(std::remove_if(edgesSource.begin(), edgesSource.end(), 
-        [target](const Edge& e){ return e.target == target; }), edgesSource.end());
-        
-    auto& edgesTarget = adj[target];
-    edgesTarget.erase(std::remove_if(edgesTarget.begin(), edgesTarget.end(), 
-        [source](const Edge& e){ return e.target == source; }), edgesTarget.end());
-
-    adj[source].push_back({target, weight});
-    adj[target].push_back({source, weight}); // Undirected
-    
-    updateGraphVisualization("Added Edge " + std::to_string(source) + "-" + std::to_string(target));
-}
+// Forwards graph changes and algorithm steps to graph.html
+class WebGraphSink : public GraphSink {
+private:
+    std::vector<int> stackTopFirst;
 
-void removeNode(int id) {
-    if (nodes.erase(id)) {
-        adj.erase(id);
-        // Remove edges pointing to this node
-        for (auto& [u, edges] : adj) {
-            edges.erase(std::remove_if(edges.begin(), edges.end(), 
-                [id](const Edge& e){ return e.target == id; }), edges.end());
+public:
+    void onSnapshot(const GraphStore& graph, GraphChange change, int a, int b) override {
+        logEvent("snapshot", getGraphData(graph), changeMessage(change, a, b));
+    }
+
+    void onVisit(int node, const int* pending, size_t count, bool isStack) override {
+        val highlightData = val::object();
+        highlightData.set("node", node);
+        if (isStack) {
+            // Show the stack top first
+            stackTopFirst.assign(pending, pending + count);
+            std::reverse(stackTopFirst.begin(), stackTopFirst.end());
+            highlightData.set("stack", val(typed_memory_view(count, stackTopFirst.data())));
+        } else {
+            highlightData.set("queue", val(typed_memory_view(count, pending)));
         }
-        updateGraphVisualization("Removed Node " + std::to_string(id));
+        logEvent("highlight", highlightData, "Visiting " + std::to_string(node));
     }
-}
 
-void removeEdge(int source, int target) {
-    bool changed = false;
-    auto& edgesSource = adj[source];
-    auto it1 = std::remove_if(edgesSource.begin(), edgesSource.end(), 
-        [target](const Edge& e){ return e.target == target; });
-    if (it1 != edgesSource.end()) {
-        edgesSource.erase(it1, edgesSource.end());
-        changed = true;
+    void onMstEdge(int source, int target) override {
+        val edgeData = val::object();
+        edgeData.set("source", source);
+        edgeData.set("target", target);
+        logEvent("mst_edge", edgeData, "Added to MST: " + std::to_string(source) + "-" + std::to_string(target));
     }
 
-    auto& edgesTarget = adj[target];
-    auto it2 = std::remove_if(edgesTarget.begin(), edgesTarget.end(), 
-        [source](const Edge& e){ return e.target == source; });
-    if (it2 != edgesTarget.end()) {
-        edgesTarget.erase(it2, edgesTarget.end());
-        changed = true;
+    void onVisitNode(int node, int dist) override {
+        val visitData = val::object();
+        visitData.set("node", node);
+        visitData.set("dist", dist);
+        logEvent("visit_node", visitData, "Relaxing Node " + std::to_string(node));
     }
-    
-    if (changed) updateGraphVisualization("Removed Edge " + std::to_string(source) + "-" + std::to_string(target));
-}
 
-void bfs(int startNode) {
-    if (nodes.find(startNode) == nodes.end()) return;
+    void onRelaxEdge(int source, int target, int newDist) override {
+        val relaxData = val::object();
+        relaxData.set("source", source);
+        relaxData.set("target", target);
+        relaxData.set("newDist", newDist);
+        logEvent("relax_edge", relaxData, "Updated distance to " + std::to_string(target));
+    }
 
-    std::queue<int> q;
-    std::set<int> visited;
-    std::vector<int> traversalOrder;
+    void onShortestPath(const std::vector<int>& path) override {
+        val pathArray = val::array();
+        for (int id : path) pathArray.call<void>("push", id);
+        logEvent("shortest_path", pathArray, "Shortest Path Found");
+    }
+
+    void onBfsLevels(const std::vector<BfsRecord>& reached) override {
+        graphSnapshot.begin(SNAPSHOT_BFS_LEVELS);
+        graphSnapshot.beginSection(3);
+        for (const auto& r : reached) graphSnapshot.put(r.node, r.level, r.parent);
+        graphSnapshot.endSection();
 
-    q.push(startNode);
-    visited.insert(startNode);
+        int depth = reached.empty() ? 0 : reached.back().level + 1;
+        logEvent("bfs_levels", graphSnapshot.view(),
+                 "BFS reached " + std::to_string(reached.size()) + " nodes in " + std::to_string(depth) + " levels");
+    }
 
-    while (!q.empty()) {
-        int u = q.front();
-        q.pop();
-        traversalOrder.push_back(u);
+    void onFinished(const char* message) override {
+        logEvent("finished", val::null(), message);
+    }
 
-        // Highlight current node
-        val highlightData = val::object();
-        highlightData.set("node", u);
-        val qArray = val::array();
-        // Queue copy for visualization (inefficient but simple)
-        std::queue<int> tempQ = q;
-        while(!tempQ.empty()) {
-            qArray.call<void>("push", tempQ.front());
-            tempQ.pop();
-        }
-        highlightData.set("queue", qArray);
-        logEvent("highlight", highlightData, "Visiting " + std::to_string(u));
-
-        // Sort neighbors for consistent traversal if needed, but vector order is fine
-        for (const auto& edge : adj[u]) {
-            if (visited.find(edge.target) == visited.end()) {
-                visited.insert(edge.target);
-                q.push(edge.target);
-            }
-        }
+    // No log message for these: they come every frame while the layout runs
+    void onLayoutNodes(const int* ids, size_t count) override {
+        logEvent("layout_nodes", val(typed_memory_view(count, ids)), "");
     }
-    logEvent("finished", val::null(), "BFS Completed");
+
+    void onLayout(const float* xy, size_t count, float alpha) override {
+        logEvent("layout", val(typed_memory_view(2 * count, xy)), "");
+    }
+};
+
+WebGraphSink webGraphSink;
+// The teaching UI wants every visit and relaxation
+Graph<FullTrace> graph(&webGraphSink);
+
+void addNode(int id) {
+    graph.addNode(id);
 }
 
-void dfs(int startNode) {
-    if (nodes.find(startNode) == nodes.end()) return;
+void addEdge(int source, int target, int weight) {
+    graph.addEdge(source, target, weight);
+}
 
-    std::stack<int> s;
-    std::set<int> visited;
-    std::vector<int> traversalOrder;
+void removeNode(int id) {
+    graph.removeNode(id);
+}
 
-    s.push(startNode);
+void removeEdge(int source, int target) {
+    graph.removeEdge(source, target);
+}
 
-    while (!s.empty()) {
-        int u = s.top();
-        s.pop();
+void bfs(int startNode) {
+    graph.bfs(startNode);
+}
 
-        if (visited.find(u) != visited.end()) continue;
-        visited.insert(u);
-        traversalOrder.push_back(u);
+void bfsLevels(int startNode) {
+    graph.bfsLevels(startNode);
+}
 
-        // Highlight
-        val highlightData = val::object();
-        highlightData.set("node", u);
-        val sArray = val::array();
-        std::stack<int> tempS = s;
-        while(!tempS.empty()) {
-            sArray.call<void>("push", tempS.top());
-            tempS.pop();
-        }
-        highlightData.set("stack", sArray);
-        logEvent("highlight", highlightData, "Visiting " + std::to_string(u));
-
-        // Push neighbors (reverse order to visit in increasing order if sorted, but here just push)
-        // For standard DFS, we usually push all neighbors.
-        for (const auto& edge : adj[u]) {
-            if (visited.find(edge.target) == visited.end()) {
-                s.push(edge.target);
-            }
-        }
-    }
-    logEvent("finished", val::null(), "DFS Completed");
+void dfs(int startNode) {
+    graph.dfs(startNode);
 }
 
 void prim(int startNode) {
-    if (nodes.find(startNode) == nodes.end()) return;
+    graph.prim(startNode);
+}
 
-    // Priority Queue: <weight, target_node, source_node>
-    // We need source_node to identify the edge for visualization
-    using PII = std::tuple<int, int, int>; 
-    std::priority_queue<PII, std::vector<PII>, std::greater<PII>> pq;
+// mode is an MstMode: 0 Prim, 1 Kruskal, 2 Boruvka
+void minimumSpanningTree(int startNode, int mode) {
+    graph.minimumSpanningTree(startNode, static_cast<MstMode>(mode));
+}
 
-    std::set<int> visited;
-    std::vector<std::pair<int, int>> mstEdges;
+void dijkstra(int startNode, int endNode) {
+    graph.dijkstra(startNode, endNode);
+}
 
-    pq.push({0, startNode, -1});
+// mode is a PathMode: 0 Dijkstra, 1 bidirectional, 2 A*
+void shortestPath(int startNode, int endNode, int mode) {
+    graph.shortestPath(startNode, endNode, static_cast<PathMode>(mode));
+}
 
-    while (!pq.empty()) {
-        auto [w, u, parent] = pq.top();
-        pq.pop();
+void clearGraph() {
+    graph.clear();
+}
 
-        if (visited.find(u) != visited.end()) continue;
-        visited.insert(u);
+// --- Stepped runs (graph_stepper.h) ---
+// graph.html drives these from requestAnimationFrame so a long run never
+// blocks the page. Both step calls return the RunStatus: 0 idle, 1 running, 2 done.
 
-        if (parent != -1) {
-            mstEdges.push_back({parent, u});
-            // Highlight MST edge
-            val edgeData = val::object();
-            edgeData.set("source", parent);
-            edgeData.set("target", u);
-            logEvent("mst_edge", edgeData, "Added to MST: " + std::to_string(parent) + "-" + std::to_string(u));
-        }
+// algorithm is a StepAlgorithm: 1 BFS, 2 DFS, 3 Prim, 4 Dijkstra (endNode
+// is only used by Dijkstra). Returns false if startNode isn't in the graph.
+bool startRun(int algorithm, int startNode, int endNode) {
+    return graph.startRun(static_cast<StepAlgorithm>(algorithm), startNode, endNode);
+}
 
-        for (const auto& edge : adj[u]) {
-            if (visited.find(edge.target) == visited.end()) {
-                pq.push({edge.weight, edge.target, u});
-            }
-        }
-    }
-    logEvent("finished", val::null(), "Prim's Algorithm Completed");
+int stepRun(int steps) {
+    return static_cast<int>(graph.step(steps > 0 ? steps : 1));
 }
 
-void dijkstra(int startNode, int endNode) {
-    if (nodes.find(startNode) == nodes.end()) return;
+int runUntil(double budgetMs) {
+    return static_cast<int>(graph.runUntil(budgetMs));
+}
 
-    std::map<int, int> dist;
-    std::map<int, int> parent;
-    for (int id : nodes) dist[id] = std::numeric_limits<int>::max();
+void cancelRun() {
+    graph.cancelRun();
+}
 
-    dist[startNode] = 0;
-    
-    // <distance, node>
-    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> pq;
-    pq.push({0, startNode});
+// Bulk load from an Int32Array of [source, target, weight] triplets
+void addEdgesBulk(val triplets) {
+    std::vector<int> flat = convertJSArrayToNumberVector<int>(triplets);
+    graph.addEdgesBulk(flat.data(), flat.size() / 3);
+}
 
-    while (!pq.empty()) {
-        int d = pq.top().first;
-        int u = pq.top().second;
-        pq.pop();
+// Layout coordinates for A*: an Int32Array of node ids and a Float32Array of [x, y] pairs
+void setNodePositions(val ids, val xy) {
+    std::vector<int> nodeIds = convertJSArrayToNumberVector<int>(ids);
+    std::vector<float> coords = convertJSArrayToNumberVector<float>(xy);
+    graph.setPositions(nodeIds.data(), coords.data(), std::min(nodeIds.size(), coords.size() / 2));
+}
 
-        if (d > dist[u]) continue;
+// --- Native force layout (force_layout.h) ---
+// graph.html switches to this above NATIVE_LAYOUT_LIMIT nodes and calls
+// layoutTick once a frame until it returns 0 (cooled).
 
-        // Visual update
-        val visitData = val::object();
-        visitData.set("node", u);
-        visitData.set("dist", d);
-        logEvent("visit_node", visitData, "Relaxing Node " + std::to_string(u));
-
-        if (u == endNode) break;
-
-        for (const auto& edge : adj[u]) {
-            if (dist[u] + edge.weight < dist[edge.target]) {
-                dist[edge.target] = dist[u] + edge.weight;
-                parent[edge.target] = u;
-                pq.push({dist[edge.target], edge.target});
-                
-                // Visual update for relaxation
-                val relaxData = val::object();
-                relaxData.set("source", u);
-                relaxData.set("target", edge.target);
-                relaxData.set("newDist", dist[edge.target]);
-                logEvent("relax_edge", relaxData, "Updated distance to " + std::to_string(edge.target));
-            }
-        }
-    }
-    
-    // Reconstruct path
-    if (dist[endNode] != std::numeric_limits<int>::max()) {
-        std::vector<int> path;
-        int curr = endNode;
-        while (curr != startNode) {
-            path.push_back(curr);
-            curr = parent[curr];
-        }
-        path.push_back(startNode);
-        std::reverse(path.begin(), path.end());
-        
-        val pathArray = val::array();
-        for (int id : path) pathArray.call<void>("push", id);
-        logEvent("shortest_path", pathArray, "Shortest Path Found");
-    } else {
-        logEvent("finished", val::null(), "No path found");
-    }
+void startLayout(float centerX, float centerY) {
+    graph.startLayout(centerX, centerY);
 }
 
-void clearGraph() {
-    adj.clear();
-    nodes.clear();
-    updateGraphVisualization("Graph Cleared");
+float layoutTick(int ticks) {
+    return graph.layoutTick(ticks > 0 ? ticks : 1);
+}
+
+void pinNode(int id, float x, float y) {
+    graph.pinNode(id, x, y);
+}
+
+void releaseNode(int id) {
+    graph.releaseNode(id);
 }
 
-} // extern "C"
+} // namespace
 
 EMSCRIPTEN_BINDINGS(graph_module) {
     function("addNode", &addNode);
@@ -319,8 +246,21 @@ EMSCRIPTEN_BINDINGS(graph_module) {
     function("removeNode", &removeNode);
     function("removeEdge", &removeEdge);
     function("bfs", &bfs);
+    function("bfsLevels", &bfsLevels);
     function("dfs", &dfs);
     function("prim", &prim);
+    function("minimumSpanningTree", &minimumSpanningTree);
     function("dijkstra", &dijkstra);
+    function("shortestPath", &shortestPath);
+    function("setNodePositions", &setNodePositions);
     function("clearGraph", &clearGraph);
+    function("startRun", &startRun);
+    function("stepRun", &stepRun);
+    function("runUntil", &runUntil);
+    function("cancelRun", &cancelRun);
+    function("addEdgesBulk", &addEdgesBulk);
+    function("startLayout", &startLayout);
+    function("layoutTick", &layoutTick);
+    function("pinNode", &pinNode);
+    function("releaseNode", &releaseNode);
 }
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include "trace.h"
+#include "graph_store.h"
+#include "shortest_path.h"
+#include "mst.h"
+#include "bfs.h"
+#include "graph_stepper.h"
+#include "force_layout.h"
+
+// Trace is NoTrace / CoarseTrace / FullTrace (see trace.h). Structural
+// snapshots and algorithm results are coarse; per-vertex visits and edge
+// relaxations are FullTrace only. Queue is the addressable heap behind
+// Dijkstra / A* / Prim (see indexed_heap.h).
+template <class Trace, class Queue = IndexedDaryHeap<4>>
+class Graph {
+private:
+    GraphStore store;
+    GraphSink* sink;
+    std::vector<int> pendingIds; // scratch for onVisit
+    ShortestPaths<Trace, Queue> paths;
+    SpanningTree<Trace, Queue> spanning;
+    FrontierBfs levelBfs;
+    GraphStepper<Trace, Queue> stepper;
+    ForceLayout layout;
+
+    // Cached A* scale, recomputed after any structural change
+    float heuristicScale = 0;
+    bool scaleDirty = true;
+
+    void notify(GraphChange change, int a, int b) {
+        scaleDirty = true;
+        layout.invalidate(change, a);
+        // A stepped run holds dense indices that may no longer mean anything
+        stepper.cancel(sink, "Run cancelled: graph changed");
+        if constexpr (Trace::coarse) sink->onSnapshot(store, change, a, b);
+    }
+
+    // Returns the dense index of id, adding it if needed
+    int insertNode(int id) {
+        auto [v, fresh] = store.addVertex(id);
+        if (fresh) notify(GraphChange::NodeAdded, id, id);
+        return v;
+    }
+
+    // Helper to hand a run of dense indices to the sink as node ids
+    void visit(int u, const int* pending, size_t count, bool isStack) {
+        pendingIds.resize(count);
+        for (size_t i = 0; i < count; i++) pendingIds[i] = store.idOf(pending[i]);
+        sink->onVisit(store.idOf(u), pendingIds.data(), count, isStack);
+    }
+
+    // A* lower bound is scale * straight-line distance. Taking the smallest
+    // weight / length ratio over all edges keeps it admissible and consistent
+    // for any layout (a layout that doesn't match the weights just makes it weak).
+    float astarScale() {
+        if (!scaleDirty) return heuristicScale;
+        float scale = std::numeric_limits<float>::max();
+        for (int u = 0; u < store.vertexCount(); u++) {
+            if (!store.alive(u)) continue;
+            store.forEachEdge(u, [&](int v, int w) {
+                float len = std::hypot(store.x(u) - store.x(v), store.y(u) - store.y(v));
+                if (len > 0) scale = std::min(scale, w / len);
+            });
+        }
+        heuristicScale = scale == std::numeric_limits<float>::max() ? 0 : std::max(scale, 0.0f);
+        scaleDirty = false;
+        return heuristicScale;
+    }
+
+public:
+    explicit Graph(GraphSink* s = &nullGraphSink) : sink(s) {}
+
+    void addNode(int id) {
+        insertNode(id);
+    }
+
+    // Undirected: stored in both adjacency lists. Re-adding an edge updates its weight.
+    void addEdge(int source, int target, int weight) {
+        int u = insertNode(source);
+        int v = insertNode(target);
+
+        // Remove existing if any
+        store.removeHalf(u, v);
+        store.removeHalf(v, u);
+
+        store.appendHalf(u, v, weight);
+        store.appendHalf(v, u, weight); // Undirected
+        store.maybeCompact();
+
+        notify(GraphChange::EdgeAdded, source, target);
+    }
+
+    // Loads edgeCount undirected edges from flat [source, target, weight]
+    // triplets and renders once (see GraphStore::loadBatch). As with addEdge,
+    // an edge that is already present (or repeated in the batch) ends up with
+    // the last weight.
+    void addEdgesBulk(const int* triplets, size_t edgeCount) {
+        store.loadBatch(triplets, edgeCount);
+
+        notify(GraphChange::BulkLoaded, static_cast<int>(edgeCount), 0);
+    }
+
+    void removeNode(int id) {
+        int v = store.find(id);
+        if (v == GraphStore::NONE) return;
+        store.removeVertex(v);
+        store.maybeCompact();
+        notify(GraphChange::NodeRemoved, id, id);
+    }
+
+    void removeEdge(int source, int target) {
+        int u = store.find(source);
+        int v = store.find(target);
+        if (u == GraphStore::NONE || v == GraphStore::NONE) return;
+
+        bool changed = store.removeHalf(u, v);
+        changed |= store.removeHalf(v, u);
+        store.maybeCompact();
+
+        if (changed) notify(GraphChange::EdgeRemoved, source, target);
+    }
+
+    void clear() {
+        store.clear();
+        notify(GraphChange::Cleared, 0, 0);
+    }
+
+    bool hasNode(int id) const { return store.find(id) != GraphStore::NONE; }
+    const GraphStore& data() const { return store; }
+
+    // --- Algorithms ---
+    // These work on dense indices and translate back to node ids for results and events.
+
+    // Returns the traversal order
+    std::vector<int> bfs(int startNode) {
+        std::vector<int> traversalOrder;
+        int start = store.find(startNode);
+        if (start == GraphStore::NONE) return traversalOrder;
+
+        // Vector-backed queue so the pending part can be handed to the sink as-is
+        std::vector<int> q;
+        size_t head = 0;
+        VisitedBits visited(store.vertexCount());
+
+        q.push_back(start);
+        visited.set(start);
+
+        while (head < q.size()) {
+            int u = q[head++];
+            traversalOrder.push_back(store.idOf(u));
+
+            // Highlight current node
+            if constexpr (Trace::full) visit(u, q.data() + head, q.size() - head, false);
+
+            store.forEachEdge(u, [&](int v, int) {
+                if (!visited.test(v)) {
+                    visited.set(v);
+                    q.push_back(v);
+                }
+            });
+        }
+        if constexpr (Trace::coarse) sink->onFinished("BFS Completed");
+        return traversalOrder;
+    }
+
+    // BFS for graphs too big to animate vertex by vertex: runs level by level
+    // (see bfs.h) and reports every reached node with its level and parent
+    // in one onBfsLevels call instead of an onVisit per vertex
+    std::vector<BfsRecord> bfsLevels(int startNode) {
+        std::vector<BfsRecord> result;
+        int start = store.find(startNode);
+        if (start == GraphStore::NONE) return result;
+
+        levelBfs.run(store, start);
+        result.reserve(levelBfs.order().size());
+        for (int v : levelBfs.order()) {
+            result.push_back({store.idOf(v), levelBfs.level(v), store.idOf(levelBfs.parent(v))});
+        }
+
+        if constexpr (Trace::coarse) {
+            sink->onBfsLevels(result);
+            sink->onFinished("BFS Completed");
+        }
+        return result;
+    }
+
+    // Returns the traversal order
+    std::vector<int> dfs(int startNode) {
+        std::vector<int> traversalOrder;
+        int start = store.find(startNode);
+        if (start == GraphStore::NONE) return traversalOrder;
+
+        std::vector<int> s;
+        VisitedBits visited(store.vertexCount());
+
+        s.push_back(start);
+
+        while (!s.empty()) {
+            int u = s.back();
+            s.pop_back();
+
+            if (visited.test(u)) continue;
+            visited.set(u);
+            traversalOrder.push_back(store.idOf(u));
+
+            // Highlight
+            if constexpr (Trace::full) visit(u, s.data(), s.size(), true);
+
+            // For standard DFS, we push all unvisited neighbors.
+            store.forEachEdge(u, [&](int v, int) {
+                if (!visited.test(v)) s.push_back(v);
+            });
+        }
+        if constexpr (Trace::coarse) sink->onFinished("DFS Completed");
+        return traversalOrder;
+    }
+
+    // Returns the MST edges as (parent, child) pairs
+    std::vector<std::pair<int, int>> prim(int startNode) {
+        return minimumSpanningTree(startNode, MstMode::Prim);
+    }
+
+    // Prim spans startNode's component; Kruskal and Boruvka span the whole
+    // graph (a forest if it is disconnected) and only need startNode to exist
+    std::vector<std::pair<int, int>> minimumSpanningTree(int startNode, MstMode mode) {
+        int start = store.find(startNode);
+        if (start == GraphStore::NONE) return {};
+
+        switch (mode) {
+            case MstMode::Kruskal:
+                return spanning.kruskal(store, sink);
+            case MstMode::Boruvka:
+                return spanning.boruvka(store, sink);
+            default:
+                return spanning.prim(store, sink, start);
+        }
+    }
+
+    // Returns the shortest path from startNode to endNode, empty if unreachable
+    std::vector<int> dijkstra(int startNode, int endNode) {
+        return shortestPath(startNode, endNode, PathMode::Dijkstra);
+    }
+
+    std::vector<int> shortestPath(int startNode, int endNode, PathMode mode) {
+        int start = store.find(startNode);
+        if (start == GraphStore::NONE) return {};
+        int end = store.find(endNode);
+
+        switch (mode) {
+            case PathMode::Bidirectional:
+                return paths.bidirectional(store, sink, start, end);
+            case PathMode::AStar: {
+                if (end == GraphStore::NONE) return paths.dijkstra(store, sink, start, end);
+                float scale = astarScale();
+                float tx = store.x(end), ty = store.y(end);
+                return paths.search(store, sink, start, end, [&](int v) {
+                    return static_cast<int>(scale * std::hypot(store.x(v) - tx, store.y(v) - ty));
+                });
+            }
+            default:
+                return paths.dijkstra(store, sink, start, end);
+        }
+    }
+
+    // --- Stepped runs (see graph_stepper.h) ---
+    // startRun sets bfs / dfs / prim / dijkstra up without doing any of it
+    // (endNode is for Dijkstra); step and runUntil then advance it. Starting
+    // a run drops the previous one. Returns false if startNode isn't in the graph.
+    bool startRun(StepAlgorithm algorithm, int startNode, int endNode = 0) {
+        stepper.cancel(sink, nullptr);
+        int start = store.find(startNode);
+        if (start == GraphStore::NONE) return false;
+
+        switch (algorithm) {
+            case StepAlgorithm::BFS: stepper.startBfs(store, start); break;
+            case StepAlgorithm::DFS: stepper.startDfs(store, start); break;
+            case StepAlgorithm::Prim: stepper.startPrim(store, start); break;
+            case StepAlgorithm::Dijkstra: stepper.startDijkstra(store, start, store.find(endNode)); break;
+            default: return false;
+        }
+        return true;
+    }
+
+    RunStatus step(size_t steps = 1) {
+        return stepper.step(store, sink, steps);
+    }
+
+    RunStatus runUntil(double budgetMs) {
+        return stepper.runUntil(store, sink, budgetMs);
+    }
+
+    void cancelRun() {
+        stepper.cancel(sink, "Run cancelled");
+    }
+
+    // Status and results of the current / last stepped run
+    const GraphStepper<Trace, Queue>& run() const { return stepper; }
+
+    // Layout coordinates for A*, as parallel arrays of node ids and [x, y] pairs.
+    // Unknown ids are skipped.
+    void setPositions(const int* ids, const float* xy, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            int v = store.find(ids[i]);
+            if (v == GraphStore::NONE) continue;
+            store.setPosition(v, xy[2 * i], xy[2 * i + 1]);
+            layout.markPlaced(ids[i]);
+        }
+        scaleDirty = true;
+    }
+
+    // --- Native layout (see force_layout.h) ---
+    // For graphs too big for the page's d3 simulation. The page restarts it
+    // with startLayout and calls layoutTick once a frame; every structural
+    // change reheats it. Positions go to the sink after each batch of ticks,
+    // in the order of the last onLayoutNodes.
+
+    void startLayout(float centerX, float centerY) {
+        layout.start(centerX, centerY);
+    }
+
+    // Returns the layout's alpha, or 0 once it has cooled and stopped
+    float layoutTick(int ticks) {
+        bool nodesChanged = layout.sync(store);
+        if constexpr (Trace::coarse) {
+            if (nodesChanged) sink->onLayoutNodes(layout.nodeIds().data(), layout.nodeIds().size());
+        }
+        if (layout.tick(store, ticks) > 0) {
+            scaleDirty = true;
+            if constexpr (Trace::coarse) sink->onLayout(layout.positions().data(), layout.nodeIds().size(), layout.alpha());
+        }
+        return layout.cooled() ? 0 : layout.alpha();
+    }
+
+    // Drag support: holds id at (x, y) until released
+    void pinNode(int id, float x, float y) {
+        layout.pin(id, x, y);
+    }
+
+    void releaseNode(int id) {
+        layout.release(id);
+    }
+};
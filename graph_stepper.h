@@ -0,0 +1,263 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <chrono>
+#include <algorithm>
+#include <utility>
+#include "trace.h"
+#include "graph_store.h"
+#include "indexed_heap.h"
+
+// Algorithms a GraphStepper can run
+enum class StepAlgorithm { None = 0, BFS = 1, DFS = 2, Prim = 3, Dijkstra = 4 };
+
+// Where a stepped run stands (returned by step / runUntil)
+//   Idle    - nothing started, or the run was cancelled
+//   Running - more steps to go
+//   Done    - finished; results stay readable until the next start
+enum class RunStatus { Idle = 0, Running = 1, Done = 2 };
+
+// Resumable bfs / dfs / prim / dijkstra. The one-shot versions in Graph run
+// to completion inside one call, which on a big graph (with FullTrace events
+// going out for every vertex) holds the caller for seconds. Here each
+// algorithm's loop state lives in the object between calls instead, so the
+// caller decides how much happens per call: step(n) does n steps,
+// runUntil(budgetMs) as many as fit in the time budget. graph.html calls
+// runUntil once per animation frame, so it can pause (stop calling), step
+// one at a time, or cancel().
+//
+// A step is one vertex: visited (BFS / DFS), added to the tree (Prim) or
+// settled (Dijkstra), with the same events the one-shot versions send.
+//
+// The run keeps dense indices into the GraphStore, so a structural change
+// must cancel it first (Graph does that in notify).
+template <class Trace, class Queue = IndexedDaryHeap<4>>
+class GraphStepper {
+private:
+    static constexpr int NONE = GraphStore::NONE;
+    static constexpr int INF = std::numeric_limits<int>::max();
+
+    StepAlgorithm algorithm = StepAlgorithm::None;
+    RunStatus state = RunStatus::Idle;
+    int target = NONE; // Dijkstra only
+
+    std::vector<int> pending; // BFS queue (from head on) or DFS stack
+    size_t head = 0;
+    VisitedBits visited{0};   // BFS / DFS reached, Prim in the tree
+    Queue frontier;           // Prim / Dijkstra
+    std::vector<int> key;     // Prim edge key / Dijkstra distance
+    std::vector<int> parent;
+    std::vector<int> pendingIds; // scratch for onVisit
+
+    // Results, in node ids
+    std::vector<int> visitOrder;
+    std::vector<std::pair<int, int>> treeEdges;
+    std::vector<int> shortest;
+
+    // Helper to reset everything a run uses and mark it running
+    void begin(StepAlgorithm a, int n) {
+        algorithm = a;
+        state = RunStatus::Running;
+        pending.clear();
+        head = 0;
+        visited = VisitedBits(n);
+        frontier.clear();
+        visitOrder.clear();
+        treeEdges.clear();
+        shortest.clear();
+    }
+
+    void finish(GraphSink* sink, const char* message) {
+        state = RunStatus::Done;
+        if constexpr (Trace::coarse) sink->onFinished(message);
+    }
+
+    // Helper to hand a run of dense indices to the sink as node ids
+    void visit(const GraphStore& g, GraphSink* sink, int u, const int* ids, size_t count, bool isStack) {
+        pendingIds.resize(count);
+        for (size_t i = 0; i < count; i++) pendingIds[i] = g.idOf(ids[i]);
+        sink->onVisit(g.idOf(u), pendingIds.data(), count, isStack);
+    }
+
+    // Finishes the run if there is nothing left to step, so the last real
+    // step already reports Done
+    void finishIfExhausted(GraphSink* sink) {
+        switch (algorithm) {
+            case StepAlgorithm::BFS:
+                if (head == pending.size()) finish(sink, "BFS Completed");
+                break;
+            case StepAlgorithm::DFS:
+                // Entries already visited by the time they surface are skipped
+                while (!pending.empty() && visited.test(pending.back())) pending.pop_back();
+                if (pending.empty()) finish(sink, "DFS Completed");
+                break;
+            case StepAlgorithm::Prim:
+                if (frontier.empty()) finish(sink, "Prim's Algorithm Completed");
+                break;
+            case StepAlgorithm::Dijkstra:
+                if (frontier.empty()) finish(sink, "No path found");
+                break;
+            default:
+                state = RunStatus::Idle;
+                break;
+        }
+    }
+
+    void stepBfs(const GraphStore& g, GraphSink* sink) {
+        int u = pending[head++];
+        visitOrder.push_back(g.idOf(u));
+        if constexpr (Trace::full) visit(g, sink, u, pending.data() + head, pending.size() - head, false);
+
+        g.forEachEdge(u, [&](int v, int) {
+            if (!visited.test(v)) {
+                visited.set(v);
+                pending.push_back(v);
+            }
+        });
+    }
+
+    void stepDfs(const GraphStore& g, GraphSink* sink) {
+        int u = pending.back();
+        pending.pop_back();
+        visited.set(u);
+        visitOrder.push_back(g.idOf(u));
+        if constexpr (Trace::full) visit(g, sink, u, pending.data(), pending.size(), true);
+
+        g.forEachEdge(u, [&](int v, int) {
+            if (!visited.test(v)) pending.push_back(v);
+        });
+    }
+
+    void stepPrim(const GraphStore& g, GraphSink* sink) {
+        int u = frontier.pop().item;
+        visited.set(u);
+        if (parent[u] != NONE) {
+            int source = g.idOf(parent[u]), child = g.idOf(u);
+            treeEdges.push_back({source, child});
+            if constexpr (Trace::coarse) sink->onMstEdge(source, child);
+        }
+
+        g.forEachEdge(u, [&](int v, int w) {
+            if (!visited.test(v) && w < key[v]) {
+                key[v] = w;
+                parent[v] = u;
+                frontier.pushOrDecrease(v, w);
+            }
+        });
+    }
+
+    void stepDijkstra(const GraphStore& g, GraphSink* sink) {
+        int u = frontier.pop().item;
+        int du = key[u];
+        visitOrder.push_back(g.idOf(u));
+        if constexpr (Trace::full) sink->onVisitNode(g.idOf(u), du);
+
+        if (u == target) {
+            for (int v = u; v != NONE; v = parent[v]) shortest.push_back(g.idOf(v));
+            std::reverse(shortest.begin(), shortest.end());
+            state = RunStatus::Done;
+            if constexpr (Trace::coarse) sink->onShortestPath(shortest);
+            return;
+        }
+
+        g.forEachEdge(u, [&](int v, int w) {
+            int nd = du + w;
+            if (nd < key[v]) {
+                key[v] = nd;
+                parent[v] = u;
+                frontier.pushOrDecrease(v, nd);
+                if constexpr (Trace::full) sink->onRelaxEdge(g.idOf(u), g.idOf(v), nd);
+            }
+        });
+    }
+
+public:
+    // --- Starting a run (dense indices; nothing happens until step) ---
+
+    void startBfs(const GraphStore& g, int start) {
+        begin(StepAlgorithm::BFS, g.vertexCount());
+        pending.push_back(start);
+        visited.set(start);
+    }
+
+    void startDfs(const GraphStore& g, int start) {
+        begin(StepAlgorithm::DFS, g.vertexCount());
+        pending.push_back(start);
+    }
+
+    void startPrim(const GraphStore& g, int start) {
+        int n = g.vertexCount();
+        begin(StepAlgorithm::Prim, n);
+        key.assign(n, INF);
+        parent.assign(n, NONE);
+        frontier.reserveItems(n);
+        key[start] = 0;
+        frontier.pushOrDecrease(start, 0);
+    }
+
+    // end may be NONE (not in the graph): like the one-shot version, the
+    // first step then just reports that there is no path
+    void startDijkstra(const GraphStore& g, int start, int end) {
+        int n = g.vertexCount();
+        begin(StepAlgorithm::Dijkstra, n);
+        target = end;
+        key.assign(n, INF);
+        parent.assign(n, NONE);
+        frontier.reserveItems(n);
+        if (end == NONE) return;
+        key[start] = 0;
+        frontier.pushOrDecrease(start, 0);
+    }
+
+    // --- Driving it ---
+
+    // Up to steps steps; stops early when the run finishes
+    RunStatus step(const GraphStore& g, GraphSink* sink, size_t steps = 1) {
+        if (state == RunStatus::Running) finishIfExhausted(sink);
+        for (size_t i = 0; i < steps && state == RunStatus::Running; i++) {
+            switch (algorithm) {
+                case StepAlgorithm::BFS: stepBfs(g, sink); break;
+                case StepAlgorithm::DFS: stepDfs(g, sink); break;
+                case StepAlgorithm::Prim: stepPrim(g, sink); break;
+                case StepAlgorithm::Dijkstra: stepDijkstra(g, sink); break;
+                default: break;
+            }
+            if (state == RunStatus::Running) finishIfExhausted(sink);
+        }
+        return state;
+    }
+
+    // Steps until budgetMs has passed (always at least one step). The clock
+    // is read every few steps; with FullTrace the sink's work (the JS event
+    // handlers, on the page) is part of what the budget covers.
+    RunStatus runUntil(const GraphStore& g, GraphSink* sink, double budgetMs) {
+        using Clock = std::chrono::steady_clock;
+        auto deadline = Clock::now() + std::chrono::duration<double, std::milli>(budgetMs);
+        constexpr size_t CLOCK_EVERY = Trace::full ? 1 : 64;
+        do {
+            step(g, sink, CLOCK_EVERY);
+        } while (state == RunStatus::Running && Clock::now() < deadline);
+        return state;
+    }
+
+    // Drops a running run; message (if any) goes out as onFinished
+    void cancel(GraphSink* sink, const char* message) {
+        if (state != RunStatus::Running) return;
+        state = RunStatus::Idle;
+        algorithm = StepAlgorithm::None;
+        if constexpr (Trace::coarse) {
+            if (message) sink->onFinished(message);
+        }
+    }
+
+    RunStatus status() const { return state; }
+    StepAlgorithm running() const { return algorithm; }
+
+    // Results so far, in node ids: visit / settle order (BFS, DFS,
+    // Dijkstra), tree edges as (parent, child) (Prim), and the path once a
+    // Dijkstra run has reached its target
+    const std::vector<int>& order() const { return visitOrder; }
+    const std::vector<std::pair<int, int>>& edges() const { return treeEdges; }
+    const std::vector<int>& path() const { return shortest; }
+};
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+// Half-edge; target is a dense vertex index (see GraphStore)
+struct Edge {
+    int target;
+    int weight;
+};
+
+// Adjacency storage, shared by every Graph instantiation; this is what sinks see.
+//
+// Node ids are remapped to dense vertex indices 0..n-1 so traversals can use
+// flat arrays instead of tree lookups. Edges live in a CSR base (offsets /
+// targets / weights, one contiguous run per vertex) plus a mutable overlay:
+//   - new edges are appended to a per-vertex overlay list
+//   - removed base edges are tombstoned (target = NONE)
+//   - removed vertices are marked dead
+// When the overlay, tombstones and dead vertices outgrow a quarter of the base,
+// compact() folds everything back into a fresh CSR, so a long run of edits
+// costs amortized O(1) per edge. Compaction renumbers vertices, so dense
+// indices are only stable between mutations.
+class GraphStore {
+public:
+    static constexpr int NONE = -1;
+
+private:
+    // Never bother compacting below this many stale entries
+    static constexpr size_t COMPACT_MIN = 1024;
+
+    std::unordered_map<int, int> index; // node id -> dense index
+    std::vector<int> ids;                // dense index -> node id
+    std::vector<uint8_t> live;
+
+    // CSR base over the first offsets.size() - 1 vertices
+    std::vector<int> offsets{0};
+    std::vector<int> targets;
+    std::vector<int> weights;
+
+    // Edges added since the last compaction
+    std::vector<std::vector<Edge>> overlay;
+
+    // Layout coordinates per vertex (0, 0 until set); used by A*
+    std::vector<float> xs, ys;
+
+    size_t liveCount = 0;
+    size_t overlayEdges = 0;
+    size_t stale = 0; // tombstoned base edges + dead vertices
+
+    bool inBase(int v) const { return static_cast<size_t>(v) + 1 < offsets.size(); }
+
+public:
+    size_t nodeCount() const { return liveCount; }
+    // Dense slots, including dead ones (size for per-vertex arrays)
+    int vertexCount() const { return static_cast<int>(ids.size()); }
+
+    int find(int id) const {
+        auto it = index.find(id);
+        return it == index.end() ? NONE : it->second;
+    }
+    int idOf(int v) const { return ids[v]; }
+    bool alive(int v) const { return live[v] != 0; }
+
+    float x(int v) const { return xs[v]; }
+    float y(int v) const { return ys[v]; }
+    void setPosition(int v, float px, float py) {
+        xs[v] = px;
+        ys[v] = py;
+    }
+
+    // Calls f(target, weight) for each edge of dense vertex v
+    template <class F>
+    void forEachEdge(int v, F&& f) const {
+        if (inBase(v)) {
+            for (int i = offsets[v], end = offsets[v + 1]; i < end; i++) {
+                if (targets[i] != NONE) f(targets[i], weights[i]);
+            }
+        }
+        for (const Edge& e : overlay[v]) f(e.target, e.weight);
+    }
+
+    // Like forEachEdge, but stops as soon as f returns true; returns whether it did
+    template <class F>
+    bool anyEdge(int v, F&& f) const {
+        if (inBase(v)) {
+            for (int i = offsets[v], end = offsets[v + 1]; i < end; i++) {
+                if (targets[i] != NONE && f(targets[i], weights[i])) return true;
+            }
+        }
+        for (const Edge& e : overlay[v]) {
+            if (f(e.target, e.weight)) return true;
+        }
+        return false;
+    }
+
+    // Degree of v, possibly over-counting edges removed since the last compaction
+    size_t degreeBound(int v) const {
+        size_t base = inBase(v) ? offsets[v + 1] - offsets[v] : 0;
+        return base + overlay[v].size();
+    }
+
+    // Half-edge count, with the same over-count
+    size_t halfEdgeBound() const { return targets.size() + overlayEdges; }
+
+    // Calls f(id) for each node
+    template <class F>
+    void forEachNode(F&& f) const {
+        for (size_t v = 0; v < ids.size(); v++) {
+            if (live[v]) f(ids[v]);
+        }
+    }
+
+    // Calls f(sourceId, targetId, weight) for each half-edge (so twice per undirected edge)
+    template <class F>
+    void forEachLink(F&& f) const {
+        for (size_t v = 0; v < ids.size(); v++) {
+            if (!live[v]) continue;
+            int source = ids[v];
+            forEachEdge(static_cast<int>(v), [&](int t, int w) { f(source, ids[t], w); });
+        }
+    }
+
+    // Returns the dense index of id and whether it was newly added
+    std::pair<int, bool> addVertex(int id) {
+        auto [it, fresh] = index.try_emplace(id, static_cast<int>(ids.size()));
+        if (fresh) {
+            ids.push_back(id);
+            live.push_back(1);
+            overlay.emplace_back();
+            xs.push_back(0);
+            ys.push_back(0);
+            liveCount++;
+        }
+        return {it->second, fresh};
+    }
+
+    void appendHalf(int u, int v, int weight) {
+        overlay[u].push_back({v, weight});
+        overlayEdges++;
+    }
+
+    // Removes the first u -> v half-edge; returns whether there was one
+    bool removeHalf(int u, int v) {
+        if (inBase(u)) {
+            for (int i = offsets[u], end = offsets[u + 1]; i < end; i++) {
+                if (targets[i] == v) {
+                    targets[i] = NONE;
+                    stale++;
+                    return true;
+                }
+            }
+        }
+        auto& edges = overlay[u];
+        for (size_t i = 0; i < edges.size(); i++) {
+            if (edges[i].target == v) {
+                edges.erase(edges.begin() + i);
+                overlayEdges--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Drops v and every edge touching it
+    void removeVertex(int v) {
+        std::vector<int> neighbors;
+        forEachEdge(v, [&](int t, int) { neighbors.push_back(t); });
+        for (int t : neighbors) {
+            if (t != v) removeHalf(t, v);
+        }
+
+        if (inBase(v)) {
+            for (int i = offsets[v], end = offsets[v + 1]; i < end; i++) {
+                if (targets[i] != NONE) {
+                    targets[i] = NONE;
+                    stale++;
+                }
+            }
+        }
+        overlayEdges -= overlay[v].size();
+        overlay[v].clear();
+
+        index.erase(ids[v]);
+        live[v] = 0;
+        liveCount--;
+        stale++;
+    }
+
+    void clear() {
+        index.clear();
+        ids.clear();
+        live.clear();
+        offsets.assign(1, 0);
+        targets.clear();
+        weights.clear();
+        overlay.clear();
+        xs.clear();
+        ys.clear();
+        liveCount = overlayEdges = stale = 0;
+    }
+
+    void maybeCompact() {
+        if (overlayEdges + stale > std::max(COMPACT_MIN, targets.size() / 4)) compact();
+    }
+
+    // Folds the overlay, tombstones and dead vertices back into the CSR
+    void compact() {
+        rebuild(nullptr, nullptr, nullptr);
+    }
+
+    // Adds edgeCount undirected edges from [source, target, weight] triplets.
+    // The half-edges are counting-sorted by source into a batch CSR that is
+    // merged in by a single rebuild, so the batch costs O(V + E) and never
+    // touches the per-vertex overlay lists.
+    void loadBatch(const int* triplets, size_t edgeCount) {
+        std::vector<int> ends(2 * edgeCount);
+        for (size_t i = 0; i < edgeCount; i++) {
+            ends[2 * i] = addVertex(triplets[3 * i]).first;
+            ends[2 * i + 1] = addVertex(triplets[3 * i + 1]).first;
+        }
+
+        std::vector<int> batchOffsets(ids.size() + 1, 0);
+        for (int v : ends) batchOffsets[v + 1]++;
+        for (size_t v = 0; v < ids.size(); v++) batchOffsets[v + 1] += batchOffsets[v];
+
+        std::vector<int> batchTargets(2 * edgeCount), batchWeights(2 * edgeCount);
+        std::vector<int> cursor(batchOffsets.begin(), batchOffsets.end() - 1);
+        for (size_t i = 0; i < edgeCount; i++) {
+            int u = ends[2 * i], v = ends[2 * i + 1];
+            int w = triplets[3 * i + 2];
+            batchTargets[cursor[u]] = v;
+            batchWeights[cursor[u]++] = w;
+            batchTargets[cursor[v]] = u; // Undirected
+            batchWeights[cursor[v]++] = w;
+        }
+
+        rebuild(batchOffsets.data(), batchTargets.data(), batchWeights.data());
+    }
+
+private:
+    // Rebuilds the CSR from the live vertices: base, then overlay, then the
+    // optional batch CSR (indexed like the current dense ids). Duplicate
+    // targets in a vertex's list collapse to the newest one, which is how
+    // re-added edges keep the last weight.
+    void rebuild(const int* batchOffsets, const int* batchTargets, const int* batchWeights) {
+        std::vector<int> renumber(ids.size(), NONE);
+        std::vector<int> newIds;
+        std::vector<float> newXs, newYs;
+        newIds.reserve(liveCount);
+        newXs.reserve(liveCount);
+        newYs.reserve(liveCount);
+        for (size_t v = 0; v < ids.size(); v++) {
+            if (live[v]) {
+                renumber[v] = static_cast<int>(newIds.size());
+                newIds.push_back(ids[v]);
+                newXs.push_back(xs[v]);
+                newYs.push_back(ys[v]);
+            }
+        }
+
+        std::vector<int> newOffsets(newIds.size() + 1, 0);
+        std::vector<int> newTargets, newWeights;
+        size_t total = targets.size() - (stale - (ids.size() - liveCount)) + overlayEdges;
+        if (batchOffsets) total += batchOffsets[ids.size()];
+        newTargets.reserve(total);
+        newWeights.reserve(total);
+
+        // lastFrom[t] == v marks t as already kept for v
+        std::vector<int> lastFrom(newIds.size(), NONE);
+        auto keep = [&](int v, int t, int w) {
+            int nt = renumber[t];
+            if (nt == NONE || lastFrom[nt] == v) return;
+            lastFrom[nt] = v;
+            newTargets.push_back(nt);
+            newWeights.push_back(w);
+        };
+
+        for (size_t v = 0; v < ids.size(); v++) {
+            int nv = renumber[v];
+            if (nv == NONE) continue;
+
+            // Walk newest to oldest so the last duplicate wins, then restore order
+            size_t start = newTargets.size();
+            if (batchOffsets) {
+                for (int i = batchOffsets[v + 1]; i-- > batchOffsets[v];) keep(nv, batchTargets[i], batchWeights[i]);
+            }
+            const auto& extra = overlay[v];
+            for (size_t i = extra.size(); i-- > 0;) keep(nv, extra[i].target, extra[i].weight);
+            if (inBase(static_cast<int>(v))) {
+                for (int i = offsets[v + 1]; i-- > offsets[v];) {
+                    if (targets[i] != NONE) keep(nv, targets[i], weights[i]);
+                }
+            }
+            std::reverse(newTargets.begin() + start, newTargets.end());
+            std::reverse(newWeights.begin() + start, newWeights.end());
+            newOffsets[nv + 1] = static_cast<int>(newTargets.size());
+        }
+
+        for (size_t v = 0; v < newIds.size(); v++) index[newIds[v]] = static_cast<int>(v);
+        ids = std::move(newIds);
+        live.assign(ids.size(), 1);
+        offsets = std::move(newOffsets);
+        targets = std::move(newTargets);
+        weights = std::move(newWeights);
+        overlay.assign(ids.size(), {});
+        xs = std::move(newXs);
+        ys = std::move(newYs);
+        overlayEdges = stale = 0;
+    }
+};
+
+// One visited bit per dense vertex
+class VisitedBits {
+private:
+    std::vector<uint64_t> words;
+
+public:
+    explicit VisitedBits(size_t n) : words((n + 63) / 64, 0) {}
+
+    bool test(int v) const { return (words[v >> 6] >> (v & 63)) & 1; }
+    void set(int v) { words[v >> 6] |= uint64_t(1) << (v & 63); }
+};
+
+// One node reached by a level BFS, in node ids. The start node has level 0
+// and is its own parent.
+struct BfsRecord {
+    int node;
+    int level;
+    int parent;
+};
+
+// What changed in a structural update (for the snapshot message)
+enum class GraphChange { NodeAdded, NodeRemoved, EdgeAdded, EdgeRemoved, Cleared, BulkLoaded };
+
+// --- Graph events ---
+// Default methods do nothing, so a plain GraphSink is the no-op sink.
+// Everything a sink receives is in node ids, not dense indices.
+class GraphSink {
+public:
+    virtual ~GraphSink() = default;
+
+    // Graph after a structural change; a/b are the node ids involved
+    // (for BulkLoaded, a is the number of edges in the batch)
+    virtual void onSnapshot(const GraphStore& graph, GraphChange change, int a, int b) {}
+    // Traversal reached node; pending is the queue (front first) or the stack (bottom first)
+    virtual void onVisit(int node, const int* pending, size_t count, bool isStack) {}
+    virtual void onMstEdge(int source, int target) {}
+    // Dijkstra settled node at distance dist
+    virtual void onVisitNode(int node, int dist) {}
+    virtual void onRelaxEdge(int source, int target, int newDist) {}
+    virtual void onShortestPath(const std::vector<int>& path) {}
+    virtual void onFinished(const char* message) {}
+    // Level-synchronous BFS result, every reached node at once (coarse)
+    virtual void onBfsLevels(const std::vector<BfsRecord>& reached) {}
+    // Native layout: the node ids it lays out, in order, whenever they change
+    virtual void onLayoutNodes(const int* ids, size_t count) {}
+    // [x, y] per node of the last onLayoutNodes, after a batch of layout ticks
+    virtual void onLayout(const float* xy, size_t count, float alpha) {}
+};
+
+inline GraphSink nullGraphSink;
@@ -2,128 +2,113 @@
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
 #include <vector>
-#include <algorithm>
 #include <iostream>
+#include "hashmap_core.h"
+#include "swiss_table.h"
+#include "snapshot.h"
 
 using namespace emscripten;
 
-// Linear Probing Implementation
-class LinearProbing {
-private:
-    std::vector<int> table;
-    int size;
-    const int EMPTY = -1;
-    const int DELETED = -2;
-
-public:
-    LinearProbing(int s) : size(s) {
-        table.assign(size, EMPTY);
-        updateVisualization();
-    }
-
-    void clear() {
-        table.assign(size, EMPTY);
-        updateVisualization();
-    }
+// File-local up to the bindings (see heap.cpp)
+namespace {
 
-    int hash(int key) {
-        return key % size;
-    }
+// --- Web bindings for the hash map engine (logic lives in hashmap_core.h) ---
 
-    bool insert(int key) {
-        // Check if already exists
-        if (searchInternal(key) != -1) return false;
-
-        int h = hash(key);
-        int start = h;
-        
-        // Linear Probe for empty slot
-        while (table[h] != EMPTY && table[h] != DELETED) {
-            h = (h + 1) % size;
-            if (h == start) return false; // Table is full
-        }
+SnapshotWriter hashMapSnapshot;
 
-        table[h] = key;
-        updateVisualization();
-        return true;
+// Forwards table changes to hashmap.html
+class WebHashMapSink : public HashMapSink {
+private:
+    // One [key, psl] record per slot (psl -1 = empty)
+    static void writeSlots(const std::vector<HashSlot>& slots) {
+        hashMapSnapshot.beginSection(2);
+        for (const HashSlot& s : slots) hashMapSnapshot.put(s.psl == EMPTY_PSL ? 0 : s.key, s.psl);
+        hashMapSnapshot.endSection();
     }
 
-    int searchInternal(int key) {
-        int h = hash(key);
-        int start = h;
+public:
+    void onSnapshot(const std::vector<HashSlot>& table, const std::vector<HashSlot>& resizing) override {
+        hashMapSnapshot.begin(SNAPSHOT_HASHMAP);
+        writeSlots(table);
+        writeSlots(resizing);
 
-        while (table[h] != EMPTY) {
-            if (table[h] == key) return h;
-            h = (h + 1) % size;
-            if (h == start) break;
-        }
-        return -1;
+        val::global("renderHashMap").call<void>("call", val::undefined(), hashMapSnapshot.view());
     }
 
-    void search(int key) {
-        int idx = searchInternal(key);
-        if (idx != -1) {
-             val::global("highlightItem").call<void>("call", val::undefined(), idx); // Pass index to highlight
-        } else {
-            // Not found
+    // One [control, key] record per slot; the page splits them into groups
+    void onGroupSnapshot(const std::vector<uint8_t>& control, const std::vector<int>& keys) override {
+        hashMapSnapshot.begin(SNAPSHOT_HASHMAP_GROUPS);
+        hashMapSnapshot.beginSection(2);
+        for (size_t i = 0; i < control.size(); i++) {
+            hashMapSnapshot.put(control[i], control[i] & 0x80 ? 0 : keys[i]);
         }
-    }
+        hashMapSnapshot.endSection();
 
-    void remove(int key) {
-        int idx = searchInternal(key);
-        if (idx != -1) {
-            table[idx] = DELETED; // Lazy deletion
-            updateVisualization();
-        }
+        val::global("renderSwissTable").call<void>("call", val::undefined(), hashMapSnapshot.view());
     }
 
-    void updateVisualization() {
-        val js_table = val::array();
-        for (int val : table) {
-            if (val == EMPTY) js_table.call<void>("push", val::null());
-            else if (val == DELETED) js_table.call<void>("push", std::string("DEL")); 
-            else js_table.call<void>("push", val);
-        }
-
-        val data = val::object();
-        data.set("table", js_table);
-        data.set("size", size);
-
-        val::global("renderHashMap").call<void>("call", val::undefined(), data);
+    void onFound(int slot, bool inResizing) override {
+        val::global("highlightItem").call<void>("call", val::undefined(), slot, inResizing);
     }
 };
 
-LinearProbing* hashMap = nullptr;
+WebHashMapSink webHashMapSink;
+
+// Engines selectable from hashmap.html
+enum HashMapEngine { ENGINE_ROBIN_HOOD = 0, ENGINE_SWISS = 1 };
+
+using WebHashMap = LinearProbing<FullTrace>;
+using WebSwissTable = SwissTable<FullTrace>;
+WebHashMap* hashMap = nullptr;
+WebSwissTable* swissTable = nullptr;
+
+// maxLoad is the Robin Hood table's grow threshold (clamped by the engine);
+// the Swiss table keeps its own fixed one
+void initHashMap(int size, int engine, float maxLoad) {
+    delete hashMap;
+    delete swissTable;
+    hashMap = nullptr;
+    swissTable = nullptr;
+    if (engine == ENGINE_SWISS) swissTable = new WebSwissTable(size, &webHashMapSink);
+    else hashMap = new WebHashMap(size, &webHashMapSink, maxLoad);
+}
 
-extern "C" void initHashMap(int size) {
-    if (hashMap) delete hashMap;
-    hashMap = new LinearProbing(size);
+// Helper to run f on whichever engine is active (both share the same API)
+template <class F>
+auto withMap(F f) {
+    if (!hashMap && !swissTable) initHashMap(20, ENGINE_ROBIN_HOOD, 0.85f);
+    return swissTable ? f(*swissTable) : f(*hashMap);
 }
 
-extern "C" bool insertHashMap(int value) {
-    if (!hashMap) initHashMap(20);
-    return hashMap->insert(value);
+bool insertHashMap(int value) {
+    return withMap([&](auto& m) { return m.insert(value); });
 }
 
-extern "C" void deleteHashMap(int value) {
-    if (!hashMap) initHashMap(20);
-    hashMap->remove(value);
+// Bulk insert from an Int32Array; returns how many keys were new
+int insertHashMapBulk(val keys) {
+    std::vector<int> data = convertJSArrayToNumberVector<int>(keys);
+    return withMap([&](auto& m) { return m.insertBulk(data.data(), data.size()); });
 }
 
-extern "C" void searchHashMap(int value) {
-    if (!hashMap) initHashMap(20);
-    hashMap->search(value);
+void deleteHashMap(int value) {
+    withMap([&](auto& m) { m.remove(value); });
 }
 
-extern "C" void clearHashMap() {
-    if (!hashMap) initHashMap(20);
-    hashMap->clear();
+void searchHashMap(int value) {
+    withMap([&](auto& m) { m.search(value); });
 }
 
+void clearHashMap() {
+    withMap([](auto& m) { m.clear(); });
+}
+
+} // namespace
+
 EMSCRIPTEN_BINDINGS(hashmap_module) {
     function("initHashMap", &initHashMap);
     function("insertHashMap", &insertHashMap);
     function("deleteHashMap", &deleteHashMap);
     function("searchHashMap", &searchHashMap);
     function("clearHashMap", &clearHashMap);
+    function("insertHashMapBulk", &insertHashMapBulk);
 }
@@ -0,0 +1,282 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include "trace.h"
+
+// One table slot. psl is the probe sequence length: how far the key sits
+// from its home slot (0 = at home), or EMPTY_PSL for a free slot.
+struct HashSlot {
+    int key;
+    int psl;
+};
+
+constexpr int EMPTY_PSL = -1;
+
+// Mixes all 32 bits of key into every output bit (lowbias32), so negative
+// keys and keys that share low bits still spread across the table
+inline uint32_t mixHash(int key) {
+    uint32_t h = static_cast<uint32_t>(key);
+    h ^= h >> 16;
+    h *= 0x7feb352dU;
+    h ^= h >> 15;
+    h *= 0x846ca68bU;
+    h ^= h >> 16;
+    return h;
+}
+
+// --- Hash map events ---
+// Default methods do nothing, so a plain HashMapSink is the no-op sink.
+class HashMapSink {
+public:
+    virtual ~HashMapSink() = default;
+
+    // Table contents after an operation. While a resize is in progress,
+    // resizing holds what is left of the previous table (empty otherwise).
+    virtual void onSnapshot(const std::vector<HashSlot>& table, const std::vector<HashSlot>& resizing) {}
+    // Swiss table contents: one control byte and key per slot, in groups (see swiss_table.h)
+    virtual void onGroupSnapshot(const std::vector<uint8_t>& control, const std::vector<int>& keys) {}
+    // A search hit the given slot (of the resizing table if inResizing)
+    virtual void onFound(int slot, bool inResizing) {}
+};
+
+inline HashMapSink nullHashMapSink;
+
+// Open addressing with linear probing, Robin Hood style
+// Trace is NoTrace / CoarseTrace / FullTrace (see trace.h)
+//
+//   - Capacity is a power of two and slots are picked from a mixed hash, so
+//     any key distribution spreads evenly and probing wraps with a mask.
+//   - Robin Hood insertion: a key that has probed further than the occupant
+//     takes its slot, which keeps probe lengths short and lets a search stop
+//     as soon as it passes a slot whose key is closer to home than it would be.
+//   - Removal shifts the rest of the cluster back one slot (no tombstones),
+//     so churn never leaves the table slower than a fresh one.
+//   - Past maxLoad the table doubles. The move is incremental: every insert
+//     or remove migrates a few whole clusters from the old table, so no
+//     single operation pays for the full rehash. Until it finishes, lookups
+//     check both tables.
+template <class Trace>
+class LinearProbing {
+private:
+    static constexpr size_t MIN_CAPACITY = 4;
+    // Old slots scanned per insert/remove while resizing. Doubling leaves the
+    // new table at most half full, so 8 is plenty to finish before it fills.
+    static constexpr size_t MIGRATE_STEP = 8;
+    static constexpr HashSlot EMPTY{0, EMPTY_PSL};
+
+    std::vector<HashSlot> table;
+    std::vector<HashSlot> old;  // previous table while resizing, else empty
+    size_t count = 0;           // keys in both tables
+    size_t oldCount = 0;        // keys still in old
+    size_t cursor = 0;          // next old slot to migrate
+    size_t scanned = 0;         // old slots migrated so far
+    float maxLoad;
+    HashMapSink* sink;
+
+    static size_t roundUp(size_t n) {
+        size_t cap = MIN_CAPACITY;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    // Helper to find key in t; returns the slot or -1
+    static int find(const std::vector<HashSlot>& t, int key) {
+        if (t.empty()) return -1;
+        size_t mask = t.size() - 1;
+        size_t i = hash(key) & mask;
+        for (int d = 0;; d++) {
+            const HashSlot& s = t[i];
+            // Empty, or the occupant is closer to home than key would be: not here
+            if (s.psl < d) return -1;
+            if (s.key == key) return static_cast<int>(i);
+            i = (i + 1) & mask;
+        }
+    }
+
+    // Robin Hood insert of a key known to be absent
+    static void place(std::vector<HashSlot>& t, int key) {
+        size_t mask = t.size() - 1;
+        size_t i = hash(key) & mask;
+        HashSlot cur{key, 0};
+        while (true) {
+            if (t[i].psl == EMPTY_PSL) {
+                t[i] = cur;
+                return;
+            }
+            if (t[i].psl < cur.psl) std::swap(t[i], cur);
+            i = (i + 1) & mask;
+            cur.psl++;
+        }
+    }
+
+    // Backward-shift deletion: pull the rest of the cluster one slot closer to home
+    static void eraseAt(std::vector<HashSlot>& t, size_t i) {
+        size_t mask = t.size() - 1;
+        size_t j = (i + 1) & mask;
+        while (t[j].psl > 0) {
+            t[i] = {t[j].key, t[j].psl - 1};
+            i = j;
+            j = (j + 1) & mask;
+        }
+        t[i] = EMPTY;
+    }
+
+    void notify() {
+        if constexpr (Trace::coarse) sink->onSnapshot(table, old);
+    }
+
+    // Moves old slots into table, at least budget of them, always finishing a
+    // cluster once started. Migration starts just after an empty slot and
+    // only ever empties whole clusters, so what is left in old is still a
+    // valid Robin Hood table (lookups and backward shifts keep working there).
+    void migrate(size_t budget) {
+        if (old.empty()) return;
+        size_t mask = old.size() - 1;
+        while (budget > 0 && oldCount > 0 && scanned < old.size()) {
+            if (old[cursor].psl == EMPTY_PSL) {
+                cursor = (cursor + 1) & mask;
+                scanned++;
+                budget--;
+                continue;
+            }
+            while (old[cursor].psl != EMPTY_PSL) {
+                place(table, old[cursor].key);
+                old[cursor] = EMPTY;
+                oldCount--;
+                cursor = (cursor + 1) & mask;
+                scanned++;
+                if (budget > 0) budget--;
+            }
+        }
+        if (oldCount == 0) {
+            old.clear();
+            old.shrink_to_fit();
+        }
+    }
+
+    void finishMigration() {
+        migrate(old.size());
+    }
+
+    // Starts moving everything into a table of newCapacity slots
+    void beginResize(size_t newCapacity) {
+        finishMigration();
+        old.swap(table);
+        table.assign(newCapacity, EMPTY);
+        oldCount = count;
+        scanned = 0;
+
+        // Start right after a gap so no cluster is split (maxLoad < 1 guarantees one)
+        size_t mask = old.size() - 1;
+        cursor = 0;
+        while (old[cursor].psl != EMPTY_PSL) cursor = (cursor + 1) & mask;
+    }
+
+    bool overLoad(size_t keys) const {
+        return static_cast<float>(keys) > maxLoad * static_cast<float>(table.size());
+    }
+
+    bool insertSilent(int key) {
+        if (find(table, key) != -1 || find(old, key) != -1) return false; // Already exists
+        if (overLoad(count + 1)) beginResize(table.size() * 2);
+        place(table, key);
+        count++;
+        migrate(MIGRATE_STEP);
+        return true;
+    }
+
+public:
+    // capacity is rounded up to a power of two; maxLoad is clamped to [0.25, 0.95]
+    explicit LinearProbing(int capacity, HashMapSink* sk = &nullHashMapSink, float maxLoadFactor = 0.85f)
+        : maxLoad(std::clamp(maxLoadFactor, 0.25f, 0.95f)), sink(sk) {
+        table.assign(roundUp(capacity > 0 ? static_cast<size_t>(capacity) : 0), EMPTY);
+        notify();
+    }
+
+    // Empties the table, keeping its current capacity
+    void clear() {
+        table.assign(table.size(), EMPTY);
+        old.clear();
+        count = oldCount = 0;
+        notify();
+    }
+
+    // The slot is hash & (capacity - 1)
+    static uint32_t hash(int key) {
+        return mixHash(key);
+    }
+
+    // Returns false if key was already present
+    bool insert(int key) {
+        if (!insertSilent(key)) return false;
+        notify();
+        return true;
+    }
+
+    // Inserts n keys and renders once; returns how many were new. The table
+    // is sized for the whole batch up front and rehashed in one go.
+    int insertBulk(const int* keys, size_t n) {
+        finishMigration();
+        if (overLoad(count + n)) {
+            size_t cap = table.size();
+            while (static_cast<float>(count + n) > maxLoad * static_cast<float>(cap)) cap <<= 1;
+            beginResize(cap);
+            finishMigration();
+        }
+
+        int inserted = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (find(table, keys[i]) != -1) continue;
+            place(table, keys[i]);
+            inserted++;
+        }
+        count += inserted;
+        notify();
+        return inserted;
+    }
+
+    bool contains(int key) const {
+        return find(table, key) != -1 || find(old, key) != -1;
+    }
+
+    // Looks key up and highlights its slot
+    bool search(int key) {
+        int idx = find(table, key);
+        bool inOld = false;
+        if (idx == -1) {
+            idx = find(old, key);
+            inOld = idx != -1;
+        }
+        if (idx == -1) return false;
+        if constexpr (Trace::coarse) sink->onFound(idx, inOld); // Pass index to highlight
+        return true;
+    }
+
+    bool remove(int key) {
+        int idx = find(table, key);
+        if (idx != -1) {
+            eraseAt(table, idx);
+        } else {
+            idx = find(old, key);
+            if (idx == -1) return false;
+            eraseAt(old, idx);
+            oldCount--;
+        }
+        count--;
+        migrate(MIGRATE_STEP);
+        notify();
+        return true;
+    }
+
+    int capacity() const { return static_cast<int>(table.size()); }
+    size_t size() const { return count; }
+    float maxLoadFactor() const { return maxLoad; }
+    bool resizing() const { return !old.empty(); }
+
+    // Raw slots of the current table, and of the previous one while resizing
+    const std::vector<HashSlot>& slots() const { return table; }
+    const std::vector<HashSlot>& resizeSlots() const { return old; }
+};
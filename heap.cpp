@@ -2,111 +2,264 @@
 #include <emscripten/bind.h>
 #include <emscripten/val.h>
 #include <vector>
-#include <algorithm>
-#include <iostream>
+#include "heap_core.h"
+#include "addressable_heap.h"
+#include "persistent_heap.h"
+#include "tree_layout.h"
+#include "snapshot.h"
 
 using namespace emscripten;
 
-// --- C++ Heap Logic ---
-std::vector<int> heap;
-bool isMinHeap = false; // Default to Max Heap
+// Everything below up to the bindings is file-local, so the engines can share
+// a link (or a page) without their globals clashing.
+namespace {
 
-// Helper to pass the heap data to JavaScript
-void updateVisualization() {
-    std::cout << "C++: updateVisualization called. Heap size: " << heap.size() << std::endl;
-    val js_heap = val::array();
-    for (size_t i = 0; i < heap.size(); ++i) {
-        js_heap.call<void>("push", heap[i]);
+// --- Web bindings for the heap engines (logic lives in heap_core.h / addressable_heap.h) ---
+
+SnapshotWriter heapSnapshot;
+
+// Slot positions for the array heap (tree_layout.h), in heap.html's spacing.
+// The implicit tree's shape only depends on the size, so sifts never move a
+// slot; a push or pop re-lays out just the path to the last slot.
+TreeLayout heapLayout(60, 80);
+int heapLayoutArity = 0;
+
+// Helper to grow or shrink the implicit tree to size slots. Slot i hangs
+// under (i - 1) / arity, so only the last slot is ever added or removed.
+void syncHeapLayout(size_t size, int arity) {
+    if (arity != heapLayoutArity) {
+        heapLayout.clear();
+        heapLayoutArity = arity;
+    }
+    while (heapLayout.size() > size) heapLayout.remove(static_cast<int>(heapLayout.size()) - 1);
+    for (int i = static_cast<int>(heapLayout.size()); static_cast<size_t>(i) < size; i++) {
+        heapLayout.add(i, i == 0 ? -1 : (i - 1) / arity, i == 0 ? 0 : (i - 1) % arity);
+    }
+    heapLayout.update();
+}
+
+// Forwards heap changes to heap.html
+class WebHeapSink : public HeapSink {
+public:
+    // Helper to pass the heap data to JavaScript
+    void onSnapshot(const std::vector<int>& values, int arity) override {
+        heapSnapshot.begin(SNAPSHOT_HEAP);
+        heapSnapshot.beginSection(1);
+        for (int v : values) heapSnapshot.put(v);
+        heapSnapshot.endSection();
+        heapSnapshot.beginSection(1);
+        heapSnapshot.put(arity);
+        heapSnapshot.endSection();
+
+        // [x, y] per slot. Every slot goes out: the page redraws from the
+        // latest snapshot alone and may skip the ones before it.
+        syncHeapLayout(values.size(), arity);
+        heapSnapshot.beginSection(2);
+        for (int i = 0; i < static_cast<int>(values.size()); i++) heapSnapshot.put(heapLayout.x(i), heapLayout.y(i));
+        heapSnapshot.endSection();
+
+        // Call the global JavaScript function 'renderHeap' with a view over the buffer
+        val::global("renderHeap").call<void>("call", val::undefined(), heapSnapshot.view());
     }
-    
-    // Call the global JavaScript function 'renderHeap'
-    val::global("renderHeap").call<void>("call", val::undefined(), js_heap);
+};
+
+WebHeapSink webHeapSink;
+// The teaching UI wants every step
+Heap<FullTrace> heap(&webHeapSink);
+
+// Engines selectable from heap.html. The addressable ones are min-heaps of
+// (key, task number) and hand out handles the page can reprioritize or remove.
+enum HeapEngine { ENGINE_ARRAY = 0, ENGINE_INDEXED = 1, ENGINE_PAIRING = 2, ENGINE_PERSISTENT = 3 };
+
+using IndexedTasks = AddressableHeap<int, IndexedDaryHeap<2>>;
+using PairingTasks = AddressableHeap<int, PairingHeap>;
+
+int heapEngine = ENGINE_ARRAY;
+int nextTask = 0;
+IndexedTasks indexedTasks;
+// Two pairing heaps on one handle space (made siblings by setHeapEngine),
+// so the page can meld B into A
+PairingTasks pairingTasks[2];
+
+// Every push and pop of the persistent heap is a version; the page gets the
+// shown one in the addressable heaps' node format (payload = handle) plus
+// its place in the history for the slider
+class WebHeapVersionSink : public VersionSink {
+public:
+    void onVersion(int version, const char* message) override;
+};
+
+WebHeapVersionSink webHeapVersionSink;
+PersistentHeap<FullTrace> persistentHeap(&webHeapVersionSink);
+
+void WebHeapVersionSink::onVersion(int version, const char* message) {
+    heapSnapshot.begin(SNAPSHOT_HEAP_NODES);
+    heapSnapshot.beginSection(5);
+    persistentHeap.forEachNode(version, [](int handle, int key, int parent) {
+        heapSnapshot.put(handle, key, handle, parent, 0);
+    });
+    heapSnapshot.endSection();
+    val::global("renderHeapNodes").call<void>("call", val::undefined(), heapSnapshot.view());
+    val::global("showHeapVersion").call<void>("call", val::undefined(), version, persistentHeap.versionCount());
+}
+
+// Helper to write one heap's nodes into the snapshot
+template <class Tasks>
+void writeTasks(const Tasks& tasks, int side) {
+    tasks.items().forEach([&](int handle, int key, int parent) {
+        heapSnapshot.put(handle, key, tasks.payload(handle), parent, side);
+    });
 }
 
-// Comparison helper
-bool shouldSwap(int parentVal, int childVal) {
-    if (isMinHeap) {
-        return childVal < parentVal; // Min Heap: Child smaller than parent -> Swap
+void renderTasks() {
+    heapSnapshot.begin(SNAPSHOT_HEAP_NODES);
+    heapSnapshot.beginSection(5);
+    if (heapEngine == ENGINE_INDEXED) {
+        writeTasks(indexedTasks, 0);
     } else {
-        return childVal > parentVal; // Max Heap: Child larger than parent -> Swap
+        writeTasks(pairingTasks[0], 0);
+        writeTasks(pairingTasks[1], 1);
     }
+    heapSnapshot.endSection();
+    val::global("renderHeapNodes").call<void>("call", val::undefined(), heapSnapshot.view());
+}
+
+// Helper to run f on the addressable heap for side (only pairing has a B side)
+template <class F>
+auto withTasks(int side, F f) {
+    return heapEngine == ENGINE_INDEXED ? f(indexedTasks) : f(pairingTasks[side == 1 ? 1 : 0]);
 }
 
-void bubbleUp(int index) {
-    if (index == 0) return;
-    int parentIndex = (index - 1) / 2;
-    
-    if (shouldSwap(heap[parentIndex], heap[index])) {
-        std::swap(heap[index], heap[parentIndex]);
-        bubbleUp(parentIndex);
+void setHeapEngine(int engine) {
+    heapEngine = engine;
+    nextTask = 0;
+    indexedTasks = IndexedTasks();
+    pairingTasks[0] = PairingTasks();
+    pairingTasks[1] = pairingTasks[0].sibling();
+    persistentHeap.clear();
+    heap.clear();
+    if (engine == ENGINE_INDEXED || engine == ENGINE_PAIRING) renderTasks();
+}
+
+// side picks heap A (0) or B (1) for the pairing engine; the others ignore it
+void insertHeap(int value, int side) {
+    if (heapEngine == ENGINE_ARRAY) {
+        heap.insert(value);
+        return;
+    }
+    if (heapEngine == ENGINE_PERSISTENT) {
+        persistentHeap.push(value);
+        return;
     }
+    withTasks(side, [&](auto& tasks) { tasks.push(value, nextTask++); });
+    renderTasks();
 }
 
-void bubbleDown(int index) {
-    int leftChild = 2 * index + 1;
-    int rightChild = 2 * index + 2;
-    int target = index;
+// Bulk load from an Int32Array (or plain array) of values
+void insertHeapBulk(val values, int side) {
+    std::vector<int> data = convertJSArrayToNumberVector<int>(values);
+    if (heapEngine == ENGINE_ARRAY) {
+        heap.insertBulk(data.data(), data.size());
+        return;
+    }
+    if (heapEngine == ENGINE_PERSISTENT) {
+        persistentHeap.pushBulk(data.data(), data.size());
+        return;
+    }
+    withTasks(side, [&](auto& tasks) {
+        for (int v : data) tasks.push(v, nextTask++);
+    });
+    renderTasks();
+}
 
-    // Find the "target" child to swap with (smallest for MinHeap, largest for MaxHeap)
-    if (leftChild < heap.size()) {
-        if (shouldSwap(heap[target], heap[leftChild])) {
-            target = leftChild;
-        }
+void extractRoot() {
+    if (heapEngine == ENGINE_ARRAY) {
+        heap.extractRoot();
+        return;
     }
-    
-    if (rightChild < heap.size()) {
-        if (shouldSwap(heap[target], heap[rightChild])) {
-            target = rightChild;
+    if (heapEngine == ENGINE_PERSISTENT) {
+        int key, handle;
+        if (persistentHeap.pop(&key, &handle)) {
+            val::global("showExtracted").call<void>("call", val::undefined(), key, handle);
         }
+        return;
     }
+    withTasks(0, [&](auto& tasks) {
+        if (tasks.empty()) return;
+        int key;
+        int task = tasks.extractRoot(&key);
+        val::global("showExtracted").call<void>("call", val::undefined(), key, task);
+    });
+    renderTasks();
+}
 
-    if (target != index) {
-        std::swap(heap[index], heap[target]);
-        bubbleDown(target);
+// Which side handle is queued on, or -1. Pairing siblings share handles, so
+// contains() can't tell A from B; the heaps are page-sized, so just look.
+int sideOf(int handle) {
+    if (heapEngine == ENGINE_ARRAY || heapEngine == ENGINE_PERSISTENT) return -1;
+    if (heapEngine == ENGINE_INDEXED) return indexedTasks.contains(handle) ? 0 : -1;
+    for (int side = 0; side < 2; side++) {
+        bool found = false;
+        pairingTasks[side].items().forEach([&](int item, int, int) { found = found || item == handle; });
+        if (found) return side;
     }
+    return -1;
 }
 
-// Re-build the entire heap (used when toggling type)
-void rebuildHeap() {
-    // Standard "heapify" algorithm: start from last non-leaf node and bubble down
-    for (int i = (heap.size() / 2) - 1; i >= 0; i--) {
-        bubbleDown(i);
-    }
-    updateVisualization();
+// Moves handle to key, up or down; false if no such handle is queued
+bool updateHeapKey(int handle, int key) {
+    int side = sideOf(handle);
+    if (side < 0) return false;
+    withTasks(side, [&](auto& tasks) { tasks.updateKey(handle, key); });
+    renderTasks();
+    return true;
 }
 
-extern "C" void insertHeap(int value) {
-    std::cout << "C++: insertHeap called with value " << value << std::endl;
-    heap.push_back(value);
-    bubbleUp(heap.size() - 1);
-    updateVisualization();
+// Drops handle wherever it is; false if no such handle is queued
+bool removeHeapHandle(int handle) {
+    int side = sideOf(handle);
+    if (side < 0) return false;
+    withTasks(side, [&](auto& tasks) { tasks.remove(handle); });
+    renderTasks();
+    return true;
 }
 
-extern "C" void extractRoot() {
-    if (heap.empty()) return;
-    
-    heap[0] = heap.back();
-    heap.pop_back();
-    if (!heap.empty()) {
-        bubbleDown(0);
+// Pairing only: splices heap B into heap A
+void meldHeaps() {
+    if (heapEngine != ENGINE_PAIRING) return;
+    pairingTasks[0].meld(pairingTasks[1]);
+    renderTasks();
+}
+
+void clearHeap() {
+    if (heapEngine == ENGINE_ARRAY) {
+        heap.clear();
+        return;
     }
-    updateVisualization();
+    setHeapEngine(heapEngine);
 }
 
-extern "C" void clearHeap() {
-    heap.clear();
-    updateVisualization();
+void toggleHeapType(bool makeMinHeap) {
+    heap.setMinHeap(makeMinHeap);
 }
 
-extern "C" void toggleHeapType(bool makeMinHeap) {
-    isMinHeap = makeMinHeap;
-    rebuildHeap();
+// Persistent engine only: shows version (0 = empty heap); false if there is none
+bool showHeapVersion(int version) {
+    return persistentHeap.checkout(version);
 }
 
+} // namespace
+
 // --- Embind Wrapper ---
 EMSCRIPTEN_BINDINGS(heap_module) {
     function("insertHeap", &insertHeap);
     function("extractRoot", &extractRoot);
     function("clearHeap", &clearHeap);
     function("toggleHeapType", &toggleHeapType);
+    function("insertHeapBulk", &insertHeapBulk);
+    function("setHeapEngine", &setHeapEngine);
+    function("updateHeapKey", &updateHeapKey);
+    function("removeHeapHandle", &removeHeapHandle);
+    function("meldHeaps", &meldHeaps);
+    function("showHeapVersion", &showHeapVersion);
 }
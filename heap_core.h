@@ -0,0 +1,216 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "trace.h"
+
+// --- Heap events ---
+// The engine reports changes through a sink; the default methods do nothing,
+// so a plain HeapSink is the no-op sink used headless and in benchmarks.
+class HeapSink {
+public:
+    virtual ~HeapSink() = default;
+
+    // Heap contents after an operation, in array order. The children of
+    // slot i are slots arity * i + 1 .. arity * i + arity.
+    virtual void onSnapshot(const std::vector<int>& heap, int arity) {}
+};
+
+inline HeapSink nullHeapSink;
+
+// Array-backed d-ary heap. before(a, b) is true when a belongs above b, so
+// std::less gives a min-heap and std::greater a max-heap; the comparator is
+// part of the type and inlines, there is no runtime min/max switch.
+//
+// Sifts are iterative and move a hole instead of swapping: elements shift
+// one level and the moving value is written once at the end. pop() uses
+// Floyd's bottom-up variant: the hole goes straight down along the best
+// children to a leaf, then the old last element sifts up from there. The
+// last element almost always belongs near the bottom, so this skips most of
+// the comparisons against it that a plain sift-down would make.
+//
+// Wider nodes make the tree shallower and keep a node's children in one
+// cache line. That is a clear win for push (fewer levels to climb); pop pays
+// Arity - 1 comparisons per level, so measure before widening a pop-heavy heap.
+template <class T, int Arity = 2, class Compare = std::less<T>>
+class DaryHeap {
+    static_assert(Arity >= 2, "a heap needs at least two children per node");
+
+private:
+    std::vector<T> items;
+    Compare before;
+
+    static size_t parentOf(size_t i) { return (i - 1) / Arity; }
+    static size_t firstChild(size_t i) { return i * Arity + 1; }
+
+    // Helper to pick the child that belongs highest among those starting at first
+    size_t bestChild(size_t first, size_t n) const {
+        size_t best = first;
+        if (first + Arity <= n) {
+            // Full node: fixed trip count and a select instead of a branch, so
+            // the compiler unrolls it and random keys don't mispredict
+            for (size_t c = first + 1; c < first + Arity; c++) {
+                best = before(items[c], items[best]) ? c : best;
+            }
+        } else {
+            for (size_t c = first + 1; c < n; c++) {
+                if (before(items[c], items[best])) best = c;
+            }
+        }
+        return best;
+    }
+
+    // Moves the hole at i up until value fits, stopping at top
+    void siftUp(size_t i, T value, size_t top = 0) {
+        while (i > top) {
+            size_t p = parentOf(i);
+            if (!before(value, items[p])) break;
+            items[i] = std::move(items[p]);
+            i = p;
+        }
+        items[i] = std::move(value);
+    }
+
+    // Floyd's bottom-up sift: hole at i down to a leaf, then value back up
+    void siftDown(size_t i, T value) {
+        size_t start = i;
+        size_t n = items.size();
+        for (size_t c = firstChild(i); c < n; c = firstChild(i)) {
+            c = bestChild(c, n);
+            items[i] = std::move(items[c]);
+            i = c;
+        }
+        siftUp(i, std::move(value), start);
+    }
+
+public:
+    bool empty() const { return items.empty(); }
+    size_t size() const { return items.size(); }
+    const T& top() const { return items.front(); }
+    void reserve(size_t n) { items.reserve(n); }
+    void clear() { items.clear(); }
+
+    // Raw array, in heap order
+    const std::vector<T>& values() const { return items; }
+
+    void push(T value) {
+        items.emplace_back();
+        siftUp(items.size() - 1, std::move(value));
+    }
+
+    // Removes and returns the top; the heap must not be empty
+    T pop() {
+        T root = std::move(items.front());
+        T last = std::move(items.back());
+        items.pop_back();
+        if (!items.empty()) siftDown(0, std::move(last));
+        return root;
+    }
+
+    // Restores heap order over the whole array in O(n)
+    void heapify() {
+        size_t n = items.size();
+        if (n < 2) return;
+        for (size_t i = parentOf(n - 1) + 1; i-- > 0;) {
+            siftDown(i, std::move(items[i]));
+        }
+    }
+
+    // Appends n values. Big batches go through heapify instead of n sift-ups.
+    void append(const T* values, size_t n) {
+        size_t total = items.size() + n;
+        items.insert(items.end(), values, values + n);
+
+        size_t logTotal = 1;
+        while ((size_t(1) << logTotal) < total) logTotal++;
+        if (n * logTotal > total) {
+            heapify();
+        } else {
+            for (size_t i = total - n; i < total; i++) siftUp(i, std::move(items[i]));
+        }
+    }
+
+    // Takes over values (any order) and heapifies them
+    void assign(std::vector<T>&& values) {
+        items = std::move(values);
+        heapify();
+    }
+
+    // Hands the array back, leaving the heap empty
+    std::vector<T> release() {
+        std::vector<T> out;
+        out.swap(items);
+        return out;
+    }
+};
+
+// --- C++ Heap Logic ---
+// Trace is NoTrace / CoarseTrace / FullTrace (see trace.h)
+//
+// Min or max is picked at runtime by the UI, so the values live in one of two
+// DaryHeap instances (one per comparator) and toggling moves them across and
+// heapifies. Only the public operations branch on the mode, not every comparison.
+template <class Trace, int Arity = 2>
+class Heap {
+private:
+    DaryHeap<int, Arity, std::less<int>> minOrder;
+    DaryHeap<int, Arity, std::greater<int>> maxOrder;
+    bool isMinHeap = false; // Default to Max Heap
+    HeapSink* sink;
+
+    // Helper to run f on whichever heap holds the values
+    template <class F>
+    auto active(F f) {
+        return isMinHeap ? f(minOrder) : f(maxOrder);
+    }
+
+    void notify() {
+        if constexpr (Trace::coarse) sink->onSnapshot(values(), Arity);
+    }
+
+public:
+    explicit Heap(HeapSink* s = &nullHeapSink) : sink(s) {}
+
+    void insert(int value) {
+        active([&](auto& h) { h.push(value); });
+        notify();
+    }
+
+    // Appends n values and renders once
+    void insertBulk(const int* values, size_t n) {
+        active([&](auto& h) { h.append(values, n); });
+        notify();
+    }
+
+    // Removes the root; returns false if the heap was empty
+    bool extractRoot(int* out = nullptr) {
+        if (empty()) return false;
+        int root = active([](auto& h) { return h.pop(); });
+        if (out) *out = root;
+        notify();
+        return true;
+    }
+
+    void clear() {
+        minOrder.clear();
+        maxOrder.clear();
+        notify();
+    }
+
+    void setMinHeap(bool makeMinHeap) {
+        if (makeMinHeap != isMinHeap) {
+            if (makeMinHeap) minOrder.assign(maxOrder.release());
+            else maxOrder.assign(minOrder.release());
+            isMinHeap = makeMinHeap;
+        }
+        notify();
+    }
+
+    bool minHeap() const { return isMinHeap; }
+    bool empty() const { return size() == 0; }
+    size_t size() const { return isMinHeap ? minOrder.size() : maxOrder.size(); }
+    int top() const { return isMinHeap ? minOrder.top() : maxOrder.top(); }
+    const std::vector<int>& values() const { return isMinHeap ? minOrder.values() : maxOrder.values(); }
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// One queued item and its priority (smaller key = higher priority)
+struct HeapEntry {
+    int key;
+    int item;
+};
+
+// --- Addressable heaps ---
+// Min-heaps of (key, item) where items are small dense integers (graph
+// vertex indices, or handles handed out by AddressableHeap). Each item is
+// queued at most once and can be found again by its index, so keys change in
+// place instead of through duplicate pushes. IndexedDaryHeap and PairingHeap
+// (pairing_heap.h) share this interface, so the graph engines and
+// AddressableHeap take either:
+//
+//   reserveItems(n), clear(), empty(), size(), contains(item), keyOf(item)
+//   top(), pop(), push(item, key), pushOrDecrease(item, key)
+//   decreaseKey(item, key), increaseKey(item, key), remove(item)
+//   sibling(), meld(other), forEach(f(item, key, parentItem))
+
+// Array-backed d-ary version. pos[] maps each item to its heap slot, so
+// decreaseKey is a single sift-up. Arity 4 keeps the tree shallow and each
+// sift-down scans one cache line of children.
+template <int Arity = 4>
+class IndexedDaryHeap {
+public:
+    using Entry = HeapEntry;
+
+private:
+    std::vector<Entry> heap;
+    std::vector<int> pos; // item -> heap slot, -1 if not queued
+
+    void place(size_t i, Entry e) {
+        heap[i] = e;
+        pos[e.item] = static_cast<int>(i);
+    }
+
+    // Moves the hole at i up until e fits, then drops e in
+    void siftUp(size_t i, Entry e) {
+        while (i > 0) {
+            size_t parent = (i - 1) / Arity;
+            if (heap[parent].key <= e.key) break;
+            place(i, heap[parent]);
+            i = parent;
+        }
+        place(i, e);
+    }
+
+    void siftDown(size_t i, Entry e) {
+        size_t n = heap.size();
+        while (true) {
+            size_t first = i * Arity + 1;
+            if (first >= n) break;
+            size_t last = first + Arity < n ? first + Arity : n;
+            size_t best = first;
+            for (size_t c = first + 1; c < last; c++) {
+                if (heap[c].key < heap[best].key) best = c;
+            }
+            if (heap[best].key >= e.key) break;
+            place(i, heap[best]);
+            i = best;
+        }
+        place(i, e);
+    }
+
+public:
+    // Makes room for items 0..n-1; keeps whatever is queued
+    void reserveItems(size_t n) {
+        if (pos.size() < n) pos.resize(n, -1);
+    }
+
+    // O(size), not O(universe)
+    void clear() {
+        for (const Entry& e : heap) pos[e.item] = -1;
+        heap.clear();
+    }
+
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+    // Items past the reserved range (pushed into a sibling since) aren't here
+    bool contains(int item) const { return static_cast<size_t>(item) < pos.size() && pos[item] >= 0; }
+    int keyOf(int item) const { return heap[pos[item]].key; }
+    const Entry& top() const { return heap.front(); }
+
+    // item must not be queued
+    void push(int item, int key) {
+        heap.push_back({key, item});
+        siftUp(heap.size() - 1, {key, item});
+    }
+
+    // Queues item, or lowers its key if it is already queued with a larger one
+    void pushOrDecrease(int item, int key) {
+        int p = pos[item];
+        if (p < 0) {
+            push(item, key);
+        } else if (key < heap[p].key) {
+            siftUp(static_cast<size_t>(p), {key, item});
+        }
+    }
+
+    // item must be queued with a key >= key
+    void decreaseKey(int item, int key) {
+        siftUp(static_cast<size_t>(pos[item]), {key, item});
+    }
+
+    // item must be queued with a key <= key
+    void increaseKey(int item, int key) {
+        siftDown(static_cast<size_t>(pos[item]), {key, item});
+    }
+
+    Entry pop() {
+        Entry root = heap.front();
+        pos[root.item] = -1;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) siftDown(0, last);
+        return root;
+    }
+
+    // Takes a queued item out from anywhere in the heap
+    void remove(int item) {
+        size_t p = static_cast<size_t>(pos[item]);
+        pos[item] = -1;
+        Entry last = heap.back();
+        heap.pop_back();
+        if (p == heap.size()) return; // it was the last slot
+
+        // The moved-in entry may belong above or below the hole
+        if (p > 0 && last.key < heap[(p - 1) / Arity].key) siftUp(p, last);
+        else siftDown(p, last);
+    }
+
+    // An empty heap over the same item universe
+    IndexedDaryHeap sibling() const {
+        IndexedDaryHeap h;
+        h.reserveItems(pos.size());
+        return h;
+    }
+
+    // Moves every item of other (which must not share items with this heap)
+    // in here. An array heap can't splice, so this is O(m log(n + m)).
+    void meld(IndexedDaryHeap& other) {
+        reserveItems(other.pos.size());
+        for (const Entry& e : other.heap) push(e.item, e.key);
+        other.clear();
+    }
+
+    // Calls f(item, key, parentItem) parent first; parentItem is -1 for the root
+    template <class F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < heap.size(); i++) {
+            f(heap[i].item, heap[i].key, i == 0 ? -1 : heap[(i - 1) / Arity].item);
+        }
+    }
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <limits>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// --- In-node key search for the multiway trees ---
+// A node's keys sit sorted in a fixed array of Width ints, with the unused
+// tail filled with KEY_PAD. Since the padding sorts after every real key, the
+// rank of x is just "how many of the Width slots are < x": no bounds, no
+// branches, and 4 keys per SIMD compare (WASM SIMD128, SSE2 or NEON when the
+// build has them; a plain loop the compiler can vectorize otherwise).
+constexpr int KEY_PAD = std::numeric_limits<int>::max();
+
+// Number of keys[0..Width) less than x: the lower-bound slot
+template <int Width>
+inline int countLess(const int* keys, int x) {
+    static_assert(Width % 4 == 0, "nodes are compared 4 keys at a time");
+    // Compare lanes are all-ones (-1) where the key is smaller, so
+    // subtracting them counts; one horizontal add at the end. (A bitmask +
+    // popcount per group is a libcall on baseline x86-64 and WASM targets.)
+#if defined(__wasm_simd128__)
+    v128_t needle = wasm_i32x4_splat(x);
+    v128_t acc = wasm_i32x4_splat(0);
+    for (int i = 0; i < Width; i += 4) {
+        acc = wasm_i32x4_sub(acc, wasm_i32x4_gt(needle, wasm_v128_load(keys + i)));
+    }
+    return wasm_i32x4_extract_lane(acc, 0) + wasm_i32x4_extract_lane(acc, 1) +
+           wasm_i32x4_extract_lane(acc, 2) + wasm_i32x4_extract_lane(acc, 3);
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128i needle = _mm_set1_epi32(x);
+    __m128i acc = _mm_setzero_si128();
+    for (int i = 0; i < Width; i += 4) {
+        acc = _mm_sub_epi32(acc, _mm_cmpgt_epi32(needle, _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i))));
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+#elif defined(__ARM_NEON)
+    int32x4_t needle = vdupq_n_s32(x);
+    int32x4_t acc = vdupq_n_s32(0);
+    for (int i = 0; i < Width; i += 4) {
+        acc = vsubq_s32(acc, vreinterpretq_s32_u32(vcltq_s32(vld1q_s32(keys + i), needle)));
+    }
+    return vgetq_lane_s32(acc, 0) + vgetq_lane_s32(acc, 1) + vgetq_lane_s32(acc, 2) + vgetq_lane_s32(acc, 3);
+#else
+    int n = 0;
+    for (int i = 0; i < Width; i++) n += keys[i] < x;
+    return n;
+#endif
+}
+
+// Number of keys[0..count) <= x: the upper-bound slot. count is needed only
+// for x == KEY_PAD, which would otherwise count the padding too.
+template <int Width>
+inline int countLessEq(const int* keys, int count, int x) {
+    return x == KEY_PAD ? count : countLess<Width>(keys, x + 1);
+}
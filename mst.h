@@ -0,0 +1,198 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <numeric>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include "trace.h"
+#include "graph_store.h"
+#include "indexed_heap.h"
+#include "parallel.h"
+
+// Selectable from graph.html next to the Prim button
+enum class MstMode { Prim = 0, Kruskal = 1, Boruvka = 2 };
+
+// Union-find over dense indices: union by rank, full path compression
+class DisjointSet {
+private:
+    std::vector<int> parent;
+    std::vector<uint8_t> rank;
+
+public:
+    void reset(size_t n) {
+        parent.resize(n);
+        std::iota(parent.begin(), parent.end(), 0);
+        rank.assign(n, 0);
+    }
+
+    int find(int v) {
+        int root = v;
+        while (parent[root] != root) root = parent[root];
+        while (parent[v] != root) {
+            int next = parent[v];
+            parent[v] = root;
+            v = next;
+        }
+        return root;
+    }
+
+    // Returns false if a and b were already in the same set
+    bool unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return false;
+        if (rank[a] < rank[b]) std::swap(a, b);
+        parent[b] = a;
+        if (rank[a] == rank[b]) rank[a]++;
+        return true;
+    }
+};
+
+// Minimum spanning tree / forest engines over a GraphStore. Each returns
+// the chosen edges as node id pairs and reports them through onMstEdge as
+// they are picked (coarse), then onFinished.
+//   - prim: the tree of start's component, grown with an addressable heap
+//     (one entry per vertex, decrease-key instead of duplicate pushes; Queue
+//     is any heap from indexed_heap.h)
+//   - kruskal: the whole forest, edges sorted once and joined with a DisjointSet
+//   - boruvka: the whole forest in O(log V) rounds; the per-vertex scan for
+//     the cheapest edge leaving each component runs across threads
+template <class Trace, class Queue = IndexedDaryHeap<4>>
+class SpanningTree {
+private:
+    static constexpr int NONE = GraphStore::NONE;
+
+    Queue frontier;
+    std::vector<int> key;
+    std::vector<int> parent;
+    DisjointSet sets;
+
+    // Candidate edge for Boruvka. Ordered by (weight, lo, hi) so ties always
+    // break the same way and the picked edges can't close a cycle.
+    struct Candidate {
+        int weight;
+        int lo;
+        int hi;
+        bool valid() const { return lo != NONE; }
+        bool operator<(const Candidate& o) const {
+            if (!o.valid()) return valid();
+            if (!valid()) return false;
+            if (weight != o.weight) return weight < o.weight;
+            if (lo != o.lo) return lo < o.lo;
+            return hi < o.hi;
+        }
+    };
+
+    void pick(const GraphStore& g, GraphSink* sink, int u, int v, std::vector<std::pair<int, int>>& out) {
+        int source = g.idOf(u), target = g.idOf(v);
+        out.push_back({source, target});
+        // Highlight MST edge
+        if constexpr (Trace::coarse) sink->onMstEdge(source, target);
+    }
+
+public:
+    std::vector<std::pair<int, int>> prim(const GraphStore& g, GraphSink* sink, int start) {
+        std::vector<std::pair<int, int>> mstEdges;
+        int n = g.vertexCount();
+        key.assign(n, std::numeric_limits<int>::max());
+        parent.assign(n, NONE);
+        frontier.clear();
+        frontier.reserveItems(n);
+        VisitedBits inTree(n);
+
+        key[start] = 0;
+        frontier.pushOrDecrease(start, 0);
+
+        while (!frontier.empty()) {
+            int u = frontier.pop().item;
+            inTree.set(u);
+            if (parent[u] != NONE) pick(g, sink, parent[u], u, mstEdges);
+
+            g.forEachEdge(u, [&](int v, int w) {
+                if (!inTree.test(v) && w < key[v]) {
+                    key[v] = w;
+                    parent[v] = u;
+                    frontier.pushOrDecrease(v, w);
+                }
+            });
+        }
+        if constexpr (Trace::coarse) sink->onFinished("Prim's Algorithm Completed");
+        return mstEdges;
+    }
+
+    std::vector<std::pair<int, int>> kruskal(const GraphStore& g, GraphSink* sink) {
+        std::vector<std::pair<int, int>> mstEdges;
+        int n = g.vertexCount();
+
+        // Each undirected edge once, from its lower endpoint
+        std::vector<Candidate> edges;
+        for (int u = 0; u < n; u++) {
+            if (!g.alive(u)) continue;
+            g.forEachEdge(u, [&](int v, int w) {
+                if (u < v) edges.push_back({w, u, v});
+            });
+        }
+        std::sort(edges.begin(), edges.end());
+
+        sets.reset(n);
+        for (const Candidate& e : edges) {
+            if (sets.unite(e.lo, e.hi)) pick(g, sink, e.lo, e.hi, mstEdges);
+        }
+        if constexpr (Trace::coarse) sink->onFinished("Kruskal's Algorithm Completed");
+        return mstEdges;
+    }
+
+    std::vector<std::pair<int, int>> boruvka(const GraphStore& g, GraphSink* sink) {
+        std::vector<std::pair<int, int>> mstEdges;
+        int n = g.vertexCount();
+        const Candidate none{0, NONE, NONE};
+
+        sets.reset(n);
+        std::vector<int> component(n);
+        std::vector<Candidate> vertexBest(n);
+        std::vector<Candidate> componentBest(n, none);
+
+        while (true) {
+            for (int v = 0; v < n; v++) component[v] = g.alive(v) ? sets.find(v) : NONE;
+
+            // Cheapest edge leaving each vertex's component (read-only, so threads are safe)
+            parallelFor(n, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    int v = static_cast<int>(i);
+                    Candidate best = none;
+                    if (component[v] != NONE) {
+                        g.forEachEdge(v, [&](int t, int w) {
+                            if (component[t] == component[v]) return;
+                            Candidate c{w, std::min(v, t), std::max(v, t)};
+                            if (c < best) best = c;
+                        });
+                    }
+                    vertexBest[v] = best;
+                }
+            });
+
+            for (int v = 0; v < n; v++) {
+                if (vertexBest[v].valid() && vertexBest[v] < componentBest[component[v]]) {
+                    componentBest[component[v]] = vertexBest[v];
+                }
+            }
+
+            size_t added = 0;
+            for (int c = 0; c < n; c++) {
+                Candidate e = componentBest[c];
+                if (!e.valid()) continue;
+                componentBest[c] = none;
+                // Both components may have picked the same edge
+                if (sets.unite(e.lo, e.hi)) {
+                    pick(g, sink, e.lo, e.hi, mstEdges);
+                    added++;
+                }
+            }
+            if (added == 0) break;
+        }
+        if constexpr (Trace::coarse) sink->onFinished("Boruvka's Algorithm Completed");
+        return mstEdges;
+    }
+};
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include "indexed_heap.h"
+
+// Pairing heap over dense items, with the same interface as IndexedDaryHeap
+// (see indexed_heap.h). A heap-ordered multiway tree: push, decreaseKey and
+// meld just link two roots in O(1); pop merges the root's children in two
+// passes (pair left to right, then fold right to left) for O(log n)
+// amortized.
+//
+// Nodes live in an item-indexed arena instead of being allocated one by one.
+// sibling() returns an empty heap on the same arena, and two heaps sharing an
+// arena meld in O(1) with every item keeping its index. Items must be unique
+// across heaps that share an arena.
+class PairingHeap {
+public:
+    using Entry = HeapEntry;
+
+private:
+    static constexpr int NIL = -1;
+    static constexpr int DETACHED = -2; // prev of an item that isn't queued
+
+    // prev is the parent for a first child, the left sibling otherwise, NIL for a root
+    struct Node {
+        int key = 0;
+        int child = NIL;
+        int next = NIL;
+        int prev = DETACHED;
+    };
+
+    std::shared_ptr<std::vector<Node>> nodes;
+    int root = NIL;
+    size_t count = 0;
+    std::vector<int> pairs; // scratch for mergePairs
+
+    Node& at(int i) { return (*nodes)[i]; }
+    const Node& at(int i) const { return (*nodes)[i]; }
+
+    // Links two roots (either may be NIL); the larger key becomes the first
+    // child of the smaller. Returns the surviving root.
+    int link(int a, int b) {
+        if (a == NIL) return b;
+        if (b == NIL) return a;
+        if (at(b).key < at(a).key) std::swap(a, b);
+        Node& parent = at(a);
+        Node& child = at(b);
+        child.next = parent.child;
+        if (parent.child != NIL) at(parent.child).prev = b;
+        child.prev = a;
+        parent.child = b;
+        return a;
+    }
+
+    // Unhooks the subtree at x (not the root) from its parent and siblings
+    void cut(int x) {
+        Node& n = at(x);
+        if (at(n.prev).child == x) at(n.prev).child = n.next;
+        else at(n.prev).next = n.next;
+        if (n.next != NIL) at(n.next).prev = n.prev;
+        n.next = n.prev = NIL;
+    }
+
+    // Two-pass merge of a sibling list into one tree; returns its root
+    int mergePairs(int first) {
+        pairs.clear();
+        while (first != NIL) {
+            int a = first;
+            int b = at(a).next;
+            first = b == NIL ? NIL : at(b).next;
+            at(a).next = at(a).prev = NIL;
+            if (b != NIL) at(b).next = at(b).prev = NIL;
+            pairs.push_back(link(a, b));
+        }
+        int merged = NIL;
+        for (size_t i = pairs.size(); i-- > 0;) merged = link(pairs[i], merged);
+        return merged;
+    }
+
+    void detach(int item) {
+        Node& n = at(item);
+        n.child = n.next = NIL;
+        n.prev = DETACHED;
+    }
+
+public:
+    PairingHeap() : nodes(std::make_shared<std::vector<Node>>()) {}
+
+    // Makes room for items 0..n-1; keeps whatever is queued
+    void reserveItems(size_t n) {
+        if (nodes->size() < n) nodes->resize(n);
+    }
+
+    // O(size), not O(universe)
+    void clear() {
+        forEach([&](int item, int, int) { detach(item); });
+        root = NIL;
+        count = 0;
+    }
+
+    bool empty() const { return root == NIL; }
+    size_t size() const { return count; }
+    // Queued here or in a heap sharing this one's arena
+    bool contains(int item) const { return at(item).prev != DETACHED; }
+    int keyOf(int item) const { return at(item).key; }
+    Entry top() const { return {at(root).key, root}; }
+
+    // item must not be queued
+    void push(int item, int key) {
+        Node& n = at(item);
+        n.key = key;
+        n.child = n.next = n.prev = NIL;
+        root = link(root, item);
+        count++;
+    }
+
+    // Queues item, or lowers its key if it is already queued with a larger one
+    void pushOrDecrease(int item, int key) {
+        if (!contains(item)) push(item, key);
+        else if (key < at(item).key) decreaseKey(item, key);
+    }
+
+    // item must be queued with a key >= key
+    void decreaseKey(int item, int key) {
+        at(item).key = key;
+        if (item == root) return;
+        cut(item);
+        root = link(root, item);
+    }
+
+    // item must be queued with a key <= key. Its children may now be out of
+    // order, so it comes out and goes back in.
+    void increaseKey(int item, int key) {
+        remove(item);
+        push(item, key);
+    }
+
+    Entry pop() {
+        int r = root;
+        Entry e{at(r).key, r};
+        root = mergePairs(at(r).child);
+        detach(r);
+        count--;
+        return e;
+    }
+
+    // Takes a queued item out from anywhere in the heap
+    void remove(int item) {
+        if (item == root) {
+            pop();
+            return;
+        }
+        cut(item);
+        int rest = mergePairs(at(item).child);
+        detach(item);
+        root = link(root, rest);
+        count--;
+    }
+
+    // An empty heap on the same arena, so the two can meld in O(1)
+    PairingHeap sibling() const {
+        PairingHeap h;
+        h.nodes = nodes;
+        return h;
+    }
+
+    // Moves every item of other in here: one link when the arenas are
+    // shared, otherwise item by item (the items keep their indices)
+    void meld(PairingHeap& other) {
+        if (other.nodes == nodes) {
+            root = link(root, other.root);
+            count += other.count;
+            other.root = NIL;
+            other.count = 0;
+            return;
+        }
+        while (!other.empty()) {
+            Entry e = other.pop();
+            reserveItems(static_cast<size_t>(e.item) + 1);
+            push(e.item, e.key);
+        }
+    }
+
+    // Calls f(item, key, parentItem) in pre-order, children in sibling
+    // order; parentItem is -1 for the root
+    template <class F>
+    void forEach(F f) const {
+        if (root == NIL) return;
+        std::vector<std::pair<int, int>> stack{{root, NIL}};
+        while (!stack.empty()) {
+            auto [item, parent] = stack.back();
+            stack.pop_back();
+            int child = at(item).child;
+            int next = at(item).next;
+            f(item, at(item).key, parent);
+            // Next sibling after this whole subtree, so push it first
+            if (parent != NIL && next != NIL) stack.push_back({next, parent});
+            if (child != NIL) stack.push_back({child, item});
+        }
+    }
+};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Threads exist natively and in WASM builds linked with -pthread; a plain
+// WASM build runs everything on the calling thread.
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define VISUALGO_THREADS 0
+#else
+#define VISUALGO_THREADS 1
+#endif
+
+inline unsigned workerCount() {
+#if VISUALGO_THREADS
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+#else
+    return 1;
+#endif
+}
+
+// Fixed set of worker threads that stay parked between jobs, so
+// level-synchronous algorithms can fan out once per level without paying
+// for thread creation each time. run() hands out grain-sized chunks of
+// [0, n) on demand and the calling thread works alongside the pool.
+// One caller at a time, and a job must not call run() itself.
+class ThreadPool {
+private:
+    std::vector<std::thread> threads;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t, size_t)>* job = nullptr;
+    size_t jobSize = 0;
+    size_t jobGrain = 1;
+    std::atomic<size_t> next{0};
+    size_t generation = 0;
+    size_t busy = 0;
+    bool stopping = false;
+
+    void drain() {
+        size_t begin;
+        while ((begin = next.fetch_add(jobGrain)) < jobSize) {
+            (*job)(begin, std::min(jobSize, begin + jobGrain));
+        }
+    }
+
+    void workerLoop() {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> l(lock);
+                wake.wait(l, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            drain();
+            {
+                std::lock_guard<std::mutex> l(lock);
+                if (--busy == 0) done.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit ThreadPool(unsigned workers) {
+#if VISUALGO_THREADS
+        for (unsigned i = 1; i < workers; i++) threads.emplace_back([this] { workerLoop(); });
+#endif
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> l(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return threads.size() + 1; }
+
+    // Calls fn(begin, end) over [0, n) in chunks of grain; returns when all are done
+    template <class F>
+    void run(size_t n, size_t grain, F&& fn) {
+        if (threads.empty() || n <= grain) {
+            if (n > 0) fn(size_t(0), n);
+            return;
+        }
+        std::function<void(size_t, size_t)> task = std::ref(fn);
+        {
+            std::lock_guard<std::mutex> l(lock);
+            job = &task;
+            jobSize = n;
+            jobGrain = grain;
+            next.store(0);
+            busy = threads.size();
+            generation++;
+        }
+        wake.notify_all();
+        drain();
+
+        std::unique_lock<std::mutex> l(lock);
+        done.wait(l, [&] { return busy == 0; });
+        job = nullptr;
+    }
+};
+
+inline ThreadPool& sharedPool() {
+    static ThreadPool pool(workerCount());
+    return pool;
+}
+
+// Runs fn(begin, end) over [0, n) on the shared pool. Ranges of a grain or
+// less aren't worth waking anyone and run inline.
+template <class F>
+void parallelFor(size_t n, F&& fn, size_t grain = 4096) {
+    sharedPool().run(n, grain, std::forward<F>(fn));
+}
+
+// Bitmap that threads can set concurrently (one bit per dense vertex)
+class AtomicBits {
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+    size_t capacity = 0;
+
+public:
+    void reset(size_t n) {
+        size_t count = (n + 63) / 64;
+        if (count > capacity) {
+            words.reset(new std::atomic<uint64_t>[count]);
+            capacity = count;
+        }
+        for (size_t i = 0; i < count; i++) words[i].store(0, std::memory_order_relaxed);
+    }
+
+    bool test(int v) const {
+        return (words[v >> 6].load(std::memory_order_relaxed) >> (v & 63)) & 1;
+    }
+
+    // Sets the bit; returns whether it was already set
+    bool testAndSet(int v) {
+        uint64_t mask = uint64_t(1) << (v & 63);
+        return (words[v >> 6].fetch_or(mask, std::memory_order_relaxed) & mask) != 0;
+    }
+};
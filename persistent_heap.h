@@ -0,0 +1,149 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include "trace.h"
+#include "version_history.h"
+
+// Immutable node of a PersistentHeap. rank is the leftist s-value: the
+// length of the right spine, which the heap keeps at most log2(n + 1).
+struct LeftistNode {
+    int key;
+    int handle; // insertion number: the node's identity for the viewer, kept by copies
+    int left;
+    int right;
+    int rank;
+    int size;
+};
+
+// Min-heap where every push and pop makes a new version (see
+// version_history.h). It is a leftist heap: everything is a merge, and a
+// merge only walks and copies the two right spines, so a version costs
+// O(log n) new nodes and shares the rest of the tree with the one before.
+// An array heap can't do that (a sift rewrites slots of one shared array),
+// which is why the versioned heap has a different shape from the others.
+template <class Trace>
+class PersistentHeap {
+public:
+    static constexpr int NONE = VersionHistory<LeftistNode>::NONE;
+
+private:
+    VersionHistory<LeftistNode> history;
+    VersionSink* sink;
+    int nextHandle = 0;
+    std::vector<int> spine; // scratch for merge
+
+    const LeftistNode& at(int n) const { return history.at(n); }
+    int rankOf(int n) const { return n == NONE ? 0 : at(n).rank; }
+    int sizeOf(int n) const { return n == NONE ? 0 : at(n).size; }
+
+    int single(int key) {
+        return history.add({key, nextHandle++, NONE, NONE, 1, 1});
+    }
+
+    // Merges two versions' subtrees: down the right spines taking the smaller
+    // root each time, then back up copying each spine node over the merged
+    // rest, with its children swapped where that keeps the leftist shape
+    int merge(int a, int b) {
+        spine.clear();
+        while (a != NONE && b != NONE) {
+            if (at(b).key < at(a).key) std::swap(a, b);
+            spine.push_back(a);
+            a = at(a).right;
+        }
+        int sub = a != NONE ? a : b;
+        for (size_t i = spine.size(); i-- > 0;) {
+            LeftistNode n = at(spine[i]);
+            int left = n.left, right = sub;
+            if (rankOf(left) < rankOf(right)) std::swap(left, right);
+            sub = history.add({n.key, n.handle, left, right, rankOf(right) + 1, sizeOf(left) + sizeOf(right) + 1});
+        }
+        return sub;
+    }
+
+    void publish(int root, const char* message) {
+        int version = history.commit(root);
+        if constexpr (Trace::coarse) sink->onVersion(version, message);
+    }
+
+public:
+    explicit PersistentHeap(VersionSink* s = &nullVersionSink) : sink(s) {}
+
+    // Returns the new node's handle
+    int push(int key) {
+        history.beginEdit();
+        int handle = nextHandle;
+        publish(merge(history.root(), single(key)), "Inserted");
+        return handle;
+    }
+
+    // All n keys in one version: singletons merged in pairs, round after
+    // round, which builds the heap in O(n)
+    void pushBulk(const int* keys, size_t n) {
+        if (n == 0) return;
+        history.beginEdit();
+        std::vector<int> queue;
+        queue.reserve(n + 1);
+        for (size_t i = 0; i < n; i++) queue.push_back(single(keys[i]));
+        for (size_t head = 0; head + 1 < queue.size(); head += 2) {
+            queue.push_back(merge(queue[head], queue[head + 1]));
+        }
+        publish(merge(history.root(), queue.back()), "Bulk Loaded");
+    }
+
+    // Removes the smallest key into key (and its handle); false if empty
+    bool pop(int* key = nullptr, int* handle = nullptr) {
+        int root = history.root();
+        if (root == NONE) return false;
+        LeftistNode top = at(root);
+        if (key) *key = top.key;
+        if (handle) *handle = top.handle;
+        history.beginEdit();
+        publish(merge(top.left, top.right), "Extracted Root");
+        return true;
+    }
+
+    // Drops every version and node
+    void clear() {
+        history.clear();
+        nextHandle = 0;
+        if constexpr (Trace::coarse) sink->onVersion(0, "Heap Cleared");
+    }
+
+    bool empty() const { return history.root() == NONE; }
+    size_t size() const { return sizeOf(history.root()); }
+    int top() const { return at(history.root()).key; }
+
+    // --- Versions ---
+
+    int versionCount() const { return history.count(); }
+    int version() const { return history.current(); }
+
+    // Shows version (0 is the empty heap); false if there is no such version.
+    // The next edit branches from it and drops the versions after it.
+    bool checkout(int version) {
+        if (!history.checkout(version)) return false;
+        if constexpr (Trace::coarse) sink->onVersion(version, "Version Restored");
+        return true;
+    }
+
+    // Calls f(handle, key, parentHandle) for every node of version, parents
+    // first and left before right; parentHandle is -1 for the root
+    template <class F>
+    void forEachNode(int version, F f) const {
+        std::vector<std::pair<int, int>> stack; // node, parent handle
+        if (history.root(version) != NONE) stack.push_back({history.root(version), -1});
+        while (!stack.empty()) {
+            auto [node, parent] = stack.back();
+            stack.pop_back();
+            const LeftistNode& n = at(node);
+            f(n.handle, n.key, parent);
+            if (n.right != NONE) stack.push_back({n.right, n.handle});
+            if (n.left != NONE) stack.push_back({n.left, n.handle});
+        }
+    }
+
+    // Nodes across all versions, and the bytes holding them
+    size_t nodeSlots() const { return history.nodeCount(); }
+    size_t reservedBytes() const { return history.reservedBytes(); }
+};
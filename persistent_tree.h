@@ -0,0 +1,370 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "trace.h"
+#include "version_history.h"
+
+// Immutable node of a PersistentTree. Children are arena indices; id is the
+// key's identity for the viewer and survives copying, so a node copied onto
+// a new path is still "the same node" to the page.
+struct PersistentNode {
+    int value;
+    int id;
+    int left;
+    int right;
+    int height;
+    int size; // keys in this subtree
+};
+
+// BST / AVL where every insert and remove makes a new version instead of
+// changing the tree: the nodes on the edited path are copied and everything
+// else is shared with the previous version (see version_history.h). A
+// version costs O(depth) nodes, so O(log n) with AVL on, and any version
+// can be shown again with checkout().
+//
+// Reads (search, rank, keys, ...) see the shown version. Like BST, AVL
+// is off until setAVL(true), which rebalances whatever is there as a new
+// version. Paths are kept in a vector, not on the call stack, so a plain
+// BST over sorted input is safe.
+template <class Trace>
+class PersistentTree {
+public:
+    static constexpr int NONE = VersionHistory<PersistentNode>::NONE;
+
+private:
+    VersionHistory<PersistentNode> history;
+    VersionSink* sink;
+    bool useAVL = false;
+    int nextId = 0;
+    size_t rotationCount = 0;
+
+    // One node on the way down: which child the path continues into, and
+    // the key its copy gets (a removal moves the successor's key up)
+    struct Step {
+        int node;
+        bool right;
+        int value;
+        int id;
+    };
+    std::vector<Step> path; // scratch
+
+    const PersistentNode& at(int n) const { return history.at(n); }
+    int heightOf(int n) const { return n == NONE ? 0 : at(n).height; }
+    int sizeOf(int n) const { return n == NONE ? 0 : at(n).size; }
+
+    // Helper to make a node over two existing subtrees
+    int make(int value, int id, int left, int right) {
+        int height = 1 + std::max(heightOf(left), heightOf(right));
+        return history.add({value, id, left, right, height, 1 + sizeOf(left) + sizeOf(right)});
+    }
+
+    // make, plus the single or double rotation AVL needs when the two sides
+    // differ by 2. The rotated nodes are made fresh too, so nothing any
+    // version points at is ever written.
+    int join(int value, int id, int left, int right) {
+        if (useAVL) {
+            int hl = heightOf(left), hr = heightOf(right);
+            if (hl > hr + 1) {
+                PersistentNode l = at(left);
+                if (heightOf(l.left) >= heightOf(l.right)) {
+                    rotationCount++;
+                    return make(l.value, l.id, l.left, make(value, id, l.right, right));
+                }
+                PersistentNode lr = at(l.right);
+                rotationCount += 2;
+                return make(lr.value, lr.id, make(l.value, l.id, l.left, lr.left), make(value, id, lr.right, right));
+            }
+            if (hr > hl + 1) {
+                PersistentNode r = at(right);
+                if (heightOf(r.right) >= heightOf(r.left)) {
+                    rotationCount++;
+                    return make(r.value, r.id, make(value, id, left, r.left), r.right);
+                }
+                PersistentNode rl = at(r.left);
+                rotationCount += 2;
+                return make(rl.value, rl.id, make(value, id, left, rl.left), make(r.value, r.id, rl.right, r.right));
+            }
+        }
+        return make(value, id, left, right);
+    }
+
+    // Copies the recorded path bottom-up over sub, the new subtree at its end
+    int rebuildPath(int sub) {
+        for (size_t i = path.size(); i-- > 0;) {
+            const Step& s = path[i];
+            const PersistentNode& n = at(s.node);
+            int left = n.left, right = n.right;
+            if (s.right) right = sub;
+            else left = sub;
+            sub = join(s.value, s.id, left, right);
+        }
+        return sub;
+    }
+
+    // Records the path to value in the shown version; returns the node
+    // holding it, or NONE (the path then ends where it would go)
+    int descend(int value) {
+        path.clear();
+        int cur = history.root();
+        while (cur != NONE) {
+            const PersistentNode& n = at(cur);
+            if (value == n.value) return cur;
+            bool right = value > n.value;
+            path.push_back({cur, right, n.value, n.id});
+            cur = right ? n.right : n.left;
+        }
+        return NONE;
+    }
+
+    // Balanced subtree over keys[lo, hi) as (value, id) pairs. Recursion
+    // depth is log n.
+    int buildBalanced(const std::vector<std::pair<int, int>>& keys, size_t lo, size_t hi) {
+        if (lo >= hi) return NONE;
+        size_t mid = lo + (hi - lo) / 2;
+        int left = buildBalanced(keys, lo, mid);
+        int right = buildBalanced(keys, mid + 1, hi);
+        return make(keys[mid].first, keys[mid].second, left, right);
+    }
+
+    // (value, id) pairs of a version in key order
+    std::vector<std::pair<int, int>> entries(int root) const {
+        std::vector<std::pair<int, int>> out;
+        std::vector<int> stack;
+        int cur = root;
+        while (cur != NONE || !stack.empty()) {
+            while (cur != NONE) {
+                stack.push_back(cur);
+                cur = at(cur).left;
+            }
+            cur = stack.back();
+            stack.pop_back();
+            out.push_back({at(cur).value, at(cur).id});
+            cur = at(cur).right;
+        }
+        return out;
+    }
+
+    void publish(int root, const char* message) {
+        int version = history.commit(root);
+        if constexpr (Trace::coarse) sink->onVersion(version, message);
+    }
+
+    // Keys < value (or <= value with inclusive), collecting the ids on the way
+    size_t rankOf(int value, bool inclusive, std::vector<int>* visited = nullptr) const {
+        size_t rank = 0;
+        for (int cur = history.root(); cur != NONE;) {
+            const PersistentNode& n = at(cur);
+            if (visited) visited->push_back(n.id);
+            if (value < n.value || (value == n.value && !inclusive)) {
+                cur = n.left;
+            } else {
+                rank += sizeOf(n.left) + 1;
+                cur = n.right;
+            }
+        }
+        return rank;
+    }
+
+public:
+    explicit PersistentTree(VersionSink* s = &nullVersionSink) : sink(s) {}
+
+    // Turning AVL on rebuilds the shown version balanced, as a new version
+    void setAVL(bool enable) {
+        useAVL = enable;
+        if (!enable || history.root() == NONE) return;
+        std::vector<std::pair<int, int>> keys = entries(history.root());
+        history.beginEdit();
+        publish(buildBalanced(keys, 0, keys.size()), "Tree Rebalanced");
+    }
+
+    // A new version, unless value is already there
+    void insert(int value) {
+        if (descend(value) != NONE) return;
+        history.beginEdit();
+        publish(rebuildPath(make(value, nextId++, NONE, NONE)), "Tree Updated");
+    }
+
+    // One new version holding the shown keys and values, rebuilt balanced in
+    // O(n) like BST::insertBulk. Returns how many keys were new.
+    int insertBulk(const int* values, size_t n) {
+        std::vector<int> added(values, values + n);
+        std::sort(added.begin(), added.end());
+        added.erase(std::unique(added.begin(), added.end()), added.end());
+
+        std::vector<std::pair<int, int>> old = entries(history.root());
+        std::vector<std::pair<int, int>> merged;
+        merged.reserve(old.size() + added.size());
+        size_t i = 0;
+        for (int v : added) {
+            while (i < old.size() && old[i].first < v) merged.push_back(old[i++]);
+            if (i < old.size() && old[i].first == v) continue;
+            merged.push_back({v, nextId++});
+        }
+        merged.insert(merged.end(), old.begin() + i, old.end());
+
+        int fresh = static_cast<int>(merged.size() - old.size());
+        if (fresh == 0) return 0;
+        history.beginEdit();
+        publish(buildBalanced(merged, 0, merged.size()), "Bulk Loaded");
+        return fresh;
+    }
+
+    // A new version, unless value isn't there. A node with two children
+    // takes its successor's key (and id), and the successor's spot goes to
+    // its right child.
+    void remove(int value) {
+        int target = descend(value);
+        if (target == NONE) return;
+
+        const PersistentNode& t = at(target);
+        int replacement;
+        if (t.left == NONE || t.right == NONE) {
+            replacement = t.left == NONE ? t.right : t.left;
+        } else {
+            size_t targetStep = path.size();
+            path.push_back({target, true, t.value, t.id});
+            int cur = t.right;
+            while (at(cur).left != NONE) {
+                path.push_back({cur, false, at(cur).value, at(cur).id});
+                cur = at(cur).left;
+            }
+            path[targetStep].value = at(cur).value;
+            path[targetStep].id = at(cur).id;
+            replacement = at(cur).right;
+        }
+
+        history.beginEdit();
+        publish(rebuildPath(replacement), "Tree Updated");
+    }
+
+    // Returns true if value is in the shown version; the path goes to the sink
+    bool search(int value) {
+        std::vector<int> visited;
+        int cur = history.root();
+        while (cur != NONE && at(cur).value != value) {
+            if constexpr (Trace::coarse) visited.push_back(at(cur).id);
+            cur = value < at(cur).value ? at(cur).left : at(cur).right;
+        }
+        if constexpr (Trace::coarse) {
+            if (cur != NONE) visited.push_back(at(cur).id);
+            sink->onSearchPath(visited);
+        }
+        return cur != NONE;
+    }
+
+    // Drops every version and node
+    void clear() {
+        history.clear();
+        nextId = 0;
+        if constexpr (Trace::coarse) sink->onVersion(0, "Tree Cleared");
+    }
+
+    // --- Versions ---
+
+    int versionCount() const { return history.count(); }
+    int version() const { return history.current(); }
+
+    // Shows version (0 is the empty tree); false if there is no such version.
+    // The next edit branches from it and drops the versions after it.
+    bool checkout(int version) {
+        if (!history.checkout(version)) return false;
+        if constexpr (Trace::coarse) sink->onVersion(version, "Version Restored");
+        return true;
+    }
+
+    // Calls f(id, value, parentId, side) for every node of version in
+    // pre-order; side is -1 for the root, 0 left, 1 right
+    template <class F>
+    void forEachNode(int version, F f) const {
+        struct Pending { int node; int parentId; int side; };
+        std::vector<Pending> stack;
+        if (history.root(version) != NONE) stack.push_back({history.root(version), -1, -1});
+        while (!stack.empty()) {
+            Pending p = stack.back();
+            stack.pop_back();
+            const PersistentNode& n = at(p.node);
+            f(n.id, n.value, p.parentId, p.side);
+            if (n.right != NONE) stack.push_back({n.right, n.id, 1});
+            if (n.left != NONE) stack.push_back({n.left, n.id, 0});
+        }
+    }
+
+    // --- Order statistics (shown version, O(depth)) ---
+
+    size_t rank(int value) {
+        if constexpr (Trace::coarse) {
+            std::vector<int> visited;
+            size_t r = rankOf(value, false, &visited);
+            sink->onSearchPath(visited);
+            return r;
+        } else {
+            return rankOf(value, false);
+        }
+    }
+
+    bool select(size_t index, int& key) {
+        std::vector<int> visited;
+        int cur = history.root();
+        while (cur != NONE) {
+            const PersistentNode& n = at(cur);
+            if constexpr (Trace::coarse) visited.push_back(n.id);
+            size_t left = sizeOf(n.left);
+            if (index == left) break;
+            if (index < left) {
+                cur = n.left;
+            } else {
+                index -= left + 1;
+                cur = n.right;
+            }
+        }
+        if constexpr (Trace::coarse) sink->onSearchPath(visited);
+        if (cur == NONE) return false;
+        key = at(cur).value;
+        return true;
+    }
+
+    size_t countRange(int lo, int hi) const {
+        if (lo > hi) return 0;
+        return rankOf(hi, true) - rankOf(lo, false);
+    }
+
+    void rangeScan(int lo, int hi, std::vector<int>& out) const {
+        std::vector<int> stack;
+        int cur = history.root();
+        while (cur != NONE || !stack.empty()) {
+            while (cur != NONE) {
+                if (at(cur).value < lo) {
+                    cur = at(cur).right;
+                } else {
+                    stack.push_back(cur);
+                    cur = at(cur).left;
+                }
+            }
+            if (stack.empty()) break;
+            int node = stack.back();
+            stack.pop_back();
+            if (at(node).value > hi) break;
+            out.push_back(at(node).value);
+            cur = at(node).right;
+        }
+    }
+
+    std::vector<int> keys() const {
+        std::vector<int> out;
+        for (const auto& e : entries(history.root())) out.push_back(e.first);
+        return out;
+    }
+
+    size_t size() const { return sizeOf(history.root()); }
+    int height() const { return heightOf(history.root()); }
+    bool avl() const { return useAVL; }
+    size_t rotations() const { return rotationCount; }
+
+    // Node memory: keys in the shown version, nodes across all versions,
+    // and the bytes holding them
+    size_t liveNodes() const { return size(); }
+    size_t nodeSlots() const { return history.nodeCount(); }
+    size_t reservedBytes() const { return history.reservedBytes(); }
+};
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+#include "tree_core.h"
+
+// Red-black tree on the shared node pool (tree_core.h). Node::tag holds the
+// color. Compared with AVL it is less strictly balanced, but an insert does
+// at most two rotations and a remove at most three; everything else is
+// recoloring. That makes it a good fit for write-heavy phases.
+//
+// No parent pointers: both fix-ups walk back up the recorded path, CLRS
+// style. Recolors are reported as tag deltas so the viewer can paint nodes.
+template <class Trace>
+class RedBlackTree : public TreeBase<Trace> {
+public:
+    static constexpr int BLACK = 0;
+    static constexpr int RED = 1;
+
+private:
+    using Base = TreeBase<Trace>;
+    using Base::root;
+    using Base::sink;
+    using Base::path;
+    using Base::setTag;
+    using Base::rightRotate;
+    using Base::leftRotate;
+    using Base::replaceChild;
+
+    static bool isRed(Node* n) { return n && n->tag == RED; }
+
+    // path[i - 1], or nullptr above the root
+    Node* parentAt(size_t i) const { return i > 0 ? path[i - 1] : nullptr; }
+
+    void insertNode(int value) {
+        path.clear();
+        Node* parent = nullptr;
+        Node* cur = root;
+        bool right = false;
+        while (cur) {
+            if (value == cur->data) return; // Duplicate keys not allowed
+            path.push_back(cur);
+            parent = cur;
+            right = value > cur->data;
+            cur = right ? cur->right : cur->left;
+        }
+
+        Node* z = this->attachLeaf(parent, right, value);
+        setTag(z, RED);
+
+        // path[i - 1] is z's parent throughout
+        size_t i = path.size();
+        while (i > 0 && isRed(path[i - 1])) {
+            Node* p = path[i - 1];
+            Node* g = path[i - 2]; // a red parent is never the root
+            bool leftSide = g->left == p;
+            Node* uncle = leftSide ? g->right : g->left;
+
+            if (isRed(uncle)) {
+                // Push the red up a level and continue from the grandparent
+                setTag(p, BLACK);
+                setTag(uncle, BLACK);
+                setTag(g, RED);
+                z = g;
+                i -= 2;
+                continue;
+            }
+
+            // Inner child: rotate it to the outside first
+            if (leftSide && z == p->right) {
+                g->left = leftRotate(p);
+                p = z;
+            } else if (!leftSide && z == p->left) {
+                g->right = rightRotate(p);
+                p = z;
+            }
+
+            setTag(p, BLACK);
+            setTag(g, RED);
+            Node* top = leftSide ? rightRotate(g) : leftRotate(g);
+            replaceChild(parentAt(i - 2), g, top);
+            break;
+        }
+        setTag(root, BLACK);
+    }
+
+    void removeNode(int value) {
+        path.clear();
+        Node* node = root;
+        while (node && node->data != value) {
+            path.push_back(node);
+            node = value < node->data ? node->left : node->right;
+        }
+        if (!node) return;
+
+        // Two children: take the successor's value, then remove the successor
+        if (node->left && node->right) {
+            path.push_back(node);
+            Node* succ = node->right;
+            while (succ->left) {
+                path.push_back(succ);
+                succ = succ->left;
+            }
+            node->data = succ->data;
+            if constexpr (Trace::coarse) sink->onValueChanged(node->id, node->data);
+            node = succ;
+        }
+
+        Node* parent = path.empty() ? nullptr : path.back();
+        Node* x = node->left ? node->left : node->right;
+        bool xLeft = parent && parent->left == node;
+        bool removedBlack = node->tag == BLACK;
+        this->splice(parent, node);
+
+        if (removedBlack) fixAfterRemove(x, xLeft);
+    }
+
+    // x took the place of a removed black node and is "doubly black". path
+    // holds x's ancestors; xLeft says which side of path.back() it is on
+    // (x itself may be null).
+    void fixAfterRemove(Node* x, bool xLeft) {
+        size_t k = path.size(); // x's parent is path[k - 1]
+        while (x != root && !isRed(x)) {
+            Node* p = path[k - 1];
+            Node* w = xLeft ? p->right : p->left; // never null: it carries the missing black
+
+            if (isRed(w)) {
+                // Red sibling: rotate it above p so x gets a black sibling
+                setTag(w, BLACK);
+                setTag(p, RED);
+                Node* top = xLeft ? leftRotate(p) : rightRotate(p);
+                replaceChild(parentAt(k - 1), p, top);
+                path.insert(path.begin() + (k - 1), w);
+                k++;
+                w = xLeft ? p->right : p->left;
+            }
+
+            if (!isRed(w->left) && !isRed(w->right)) {
+                // Pull a black off both children and move the problem up
+                setTag(w, RED);
+                x = p;
+                k--;
+                if (k > 0) xLeft = path[k - 1]->left == x;
+                continue;
+            }
+
+            // Make the far nephew red, then one rotation at p finishes it
+            if (xLeft && !isRed(w->right)) {
+                setTag(w->left, BLACK);
+                setTag(w, RED);
+                p->right = rightRotate(w);
+                w = p->right;
+            } else if (!xLeft && !isRed(w->left)) {
+                setTag(w->right, BLACK);
+                setTag(w, RED);
+                p->left = leftRotate(w);
+                w = p->left;
+            }
+
+            setTag(w, p->tag);
+            setTag(p, BLACK);
+            setTag(xLeft ? w->right : w->left, BLACK);
+            Node* top = xLeft ? leftRotate(p) : rightRotate(p);
+            replaceChild(parentAt(k - 1), p, top);
+            x = root;
+        }
+        if (x) setTag(x, BLACK);
+    }
+
+    // Balanced build colors every node black except a partial bottom level,
+    // which goes red; that keeps black heights equal on every path
+    void colorBalanced(size_t n) {
+        int fullLevels = 0;
+        while ((size_t(2) << fullLevels) - 1 <= n) fullLevels++;
+        bool partial = (size_t(1) << fullLevels) - 1 != n;
+        if (!partial || !root) return;
+
+        // Iterative walk with depths; the bottom level is depth fullLevels
+        std::vector<std::pair<Node*, int>> stack{{root, 0}};
+        while (!stack.empty()) {
+            auto [node, depth] = stack.back();
+            stack.pop_back();
+            if (depth == fullLevels) setTag(node, RED);
+            if (node->left) stack.push_back({node->left, depth + 1});
+            if (node->right) stack.push_back({node->right, depth + 1});
+        }
+    }
+
+public:
+    explicit RedBlackTree(TreeSink* s = &nullTreeSink) : Base(s) {}
+
+    void insert(int value) {
+        insertNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    void remove(int value) {
+        removeNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    // Merges in n values and rebuilds balanced in O(n), rendering once.
+    // Returns how many keys were new.
+    int insertBulk(const int* values, size_t n) {
+        size_t existing;
+        std::vector<int> merged = this->mergeKeys(values, n, existing);
+        this->rebuildFrom(merged);
+        colorBalanced(merged.size());
+
+        if constexpr (Trace::coarse) sink->onCommit(root, "Bulk Loaded");
+        return static_cast<int>(merged.size() - existing);
+    }
+};
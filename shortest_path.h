@@ -0,0 +1,169 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include "trace.h"
+#include "graph_store.h"
+#include "indexed_heap.h"
+
+// Selectable from graph.html next to the Dijkstra button
+enum class PathMode { Dijkstra = 0, Bidirectional = 1, AStar = 2 };
+
+// Point-to-point shortest paths over a GraphStore (non-negative weights),
+// driven by an addressable heap with decrease-key (an indexed 4-ary heap by
+// default; any Queue from indexed_heap.h works, e.g. PairingHeap). dist/parent are dense
+// arrays kept between queries and only the entries the last query touched
+// get reset, so a short query on a huge graph doesn't pay O(V) up front.
+//
+// Events match the old Dijkstra: onVisitNode when a vertex is settled,
+// onRelaxEdge when its distance improves (FullTrace), then onShortestPath or
+// "No path found" (coarse). Results and events use node ids.
+template <class Trace, class Queue = IndexedDaryHeap<4>>
+class ShortestPaths {
+private:
+    static constexpr int INF = std::numeric_limits<int>::max();
+    static constexpr int NONE = GraphStore::NONE;
+
+    // [0] is the search from the start, [1] the one from the end (bidirectional only)
+    std::vector<int> dist[2];
+    std::vector<int> parent[2];
+    Queue frontier[2];
+    std::vector<int> touched;
+
+    void prepare(int n) {
+        for (int v : touched) {
+            if (v >= n) continue;
+            for (int side = 0; side < 2; side++) {
+                dist[side][v] = INF;
+                parent[side][v] = NONE;
+            }
+        }
+        touched.clear();
+        for (int side = 0; side < 2; side++) {
+            dist[side].resize(n, INF);
+            parent[side].resize(n, NONE);
+            frontier[side].clear();
+            frontier[side].reserveItems(n);
+        }
+    }
+
+    // Helper to lower dist[side][v]; returns whether it improved
+    bool relax(int side, int v, int d, int from) {
+        if (d >= dist[side][v]) return false;
+        if (dist[0][v] == INF && dist[1][v] == INF) touched.push_back(v);
+        dist[side][v] = d;
+        parent[side][v] = from;
+        return true;
+    }
+
+    std::vector<int> finish(GraphSink* sink, std::vector<int> path) {
+        if (!path.empty()) {
+            if constexpr (Trace::coarse) sink->onShortestPath(path);
+        } else {
+            if constexpr (Trace::coarse) sink->onFinished("No path found");
+        }
+        return path;
+    }
+
+    // Node ids from the start of side's search tree down to v
+    void appendTreePath(const GraphStore& g, int side, int v, std::vector<int>& out) const {
+        size_t from = out.size();
+        for (int curr = v; curr != NONE; curr = parent[side][curr]) out.push_back(g.idOf(curr));
+        std::reverse(out.begin() + from, out.end());
+    }
+
+public:
+    // A* from s to t (dense indices). h(v) must never overestimate the
+    // remaining distance and must be consistent (h(u) <= w(u, v) + h(v));
+    // a heuristic of 0 is plain Dijkstra.
+    template <class Heuristic>
+    std::vector<int> search(const GraphStore& g, GraphSink* sink, int s, int t, Heuristic h) {
+        std::vector<int> path;
+        if (t == NONE) return finish(sink, path);
+        prepare(g.vertexCount());
+
+        auto& d = dist[0];
+        auto& open = frontier[0];
+        relax(0, s, 0, NONE);
+        open.pushOrDecrease(s, h(s));
+
+        while (!open.empty()) {
+            int u = open.pop().item;
+            int du = d[u];
+
+            // Visual update
+            if constexpr (Trace::full) sink->onVisitNode(g.idOf(u), du);
+
+            if (u == t) {
+                appendTreePath(g, 0, t, path);
+                break;
+            }
+
+            g.forEachEdge(u, [&](int v, int w) {
+                int nd = du + w;
+                if (relax(0, v, nd, u)) {
+                    open.pushOrDecrease(v, nd + h(v));
+                    // Visual update for relaxation
+                    if constexpr (Trace::full) sink->onRelaxEdge(g.idOf(u), g.idOf(v), nd);
+                }
+            });
+        }
+        return finish(sink, path);
+    }
+
+    std::vector<int> dijkstra(const GraphStore& g, GraphSink* sink, int s, int t) {
+        return search(g, sink, s, t, [](int) { return 0; });
+    }
+
+    // Grows one search from each end, always expanding the smaller frontier,
+    // and stops once the two frontier minimums together can't beat the best
+    // meeting found so far. Edges are undirected, so both sides walk the same lists.
+    std::vector<int> bidirectional(const GraphStore& g, GraphSink* sink, int s, int t) {
+        std::vector<int> path;
+        if (t == NONE) return finish(sink, path);
+        prepare(g.vertexCount());
+
+        relax(0, s, 0, NONE);
+        frontier[0].pushOrDecrease(s, 0);
+        relax(1, t, 0, NONE);
+        frontier[1].pushOrDecrease(t, 0);
+
+        // Best s-t distance seen, through the edge meetFrom (start side) -> meetTo (end side)
+        long long best = s == t ? 0 : INF;
+        int meetFrom = s == t ? s : NONE;
+        int meetTo = meetFrom;
+
+        while (!frontier[0].empty() && !frontier[1].empty()) {
+            if (static_cast<long long>(frontier[0].top().key) + frontier[1].top().key >= best) break;
+
+            int side = frontier[0].size() <= frontier[1].size() ? 0 : 1;
+            int u = frontier[side].pop().item;
+            int du = dist[side][u];
+
+            if constexpr (Trace::full) sink->onVisitNode(g.idOf(u), du);
+
+            g.forEachEdge(u, [&](int v, int w) {
+                int nd = du + w;
+                if (relax(side, v, nd, u)) {
+                    frontier[side].pushOrDecrease(v, nd);
+                    if constexpr (Trace::full) sink->onRelaxEdge(g.idOf(u), g.idOf(v), nd);
+                }
+                int other = dist[1 - side][v];
+                if (other != INF && static_cast<long long>(nd) + other < best) {
+                    best = static_cast<long long>(nd) + other;
+                    meetFrom = side == 0 ? u : v;
+                    meetTo = side == 0 ? v : u;
+                }
+            });
+        }
+
+        if (meetFrom != NONE) {
+            appendTreePath(g, 0, meetFrom, path);
+            // Then walk the end side's tree from the meeting point out to t
+            int curr = meetTo == meetFrom ? parent[1][meetTo] : meetTo;
+            for (; curr != NONE; curr = parent[1][curr]) path.push_back(g.idOf(curr));
+        }
+        return finish(sink, path);
+    }
+};
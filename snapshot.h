@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/val.h>
+#endif
+
+// Kinds of snapshot understood by snapshot.js
+enum SnapshotKind : int32_t {
+    SNAPSHOT_HEAP = 1,
+    SNAPSHOT_HASHMAP = 2,
+    SNAPSHOT_TREE = 3,
+    SNAPSHOT_GRAPH = 4,
+    SNAPSHOT_TREE_DELTA = 5,
+    SNAPSHOT_BFS_LEVELS = 6,
+    SNAPSHOT_HASHMAP_GROUPS = 7,
+    SNAPSHOT_HEAP_NODES = 8,
+    SNAPSHOT_BTREE = 9,
+};
+
+// Binary snapshot of a data structure, written as a flat run of int32 words.
+// The buffer lives in the WASM heap and is handed to JS as a typed-array view,
+// so a whole structure crosses the boundary in one call instead of one
+// val::call per element. snapshot.js decodes it on the JS side.
+//
+// Layout:
+//   [kind, sectionCount, section...]
+//   section = [count, stride, count * stride words]
+//
+// The view is only valid until the next call into the module (the buffer is
+// reused between snapshots), so JS must decode it right away.
+class SnapshotWriter {
+private:
+    std::vector<int32_t> words;
+    size_t sectionStart = 0;
+
+public:
+    void begin(int32_t kind) {
+        words.clear();
+        words.push_back(kind);
+        words.push_back(0); // section count, bumped by endSection
+    }
+
+    void beginSection(int32_t stride) {
+        sectionStart = words.size();
+        words.push_back(0); // record count, patched by endSection
+        words.push_back(stride);
+    }
+
+    void endSection() {
+        int32_t stride = words[sectionStart + 1];
+        size_t payload = words.size() - sectionStart - 2;
+        words[sectionStart] = stride > 0 ? static_cast<int32_t>(payload / stride) : 0;
+        words[1]++;
+    }
+
+    void reserve(size_t n) {
+        words.reserve(n);
+    }
+
+    // Appends one or more words (typically one record)
+    template <class... Words>
+    void put(Words... w) {
+        (words.push_back(static_cast<int32_t>(w)), ...);
+    }
+
+    bool empty() const { return words.empty(); }
+    void reset() { words.clear(); }
+
+    const int32_t* data() const { return words.data(); }
+    size_t size() const { return words.size(); }
+
+#ifdef __EMSCRIPTEN__
+    // Zero-copy Int32Array over the buffer
+    emscripten::val view() const {
+        return emscripten::val(emscripten::typed_memory_view(words.size(), words.data()));
+    }
+#endif
+};
@@ -0,0 +1,167 @@
+// Decoders for the binary snapshots written by snapshot.h.
+// C++ hands us an Int32Array that views the WASM heap directly, so these must
+// run before the next call into the module (the buffer is reused). Pages
+// hosting their engine in a worker (engine_host.js) get a copy instead.
+
+const SnapshotKind = { HEAP: 1, HASHMAP: 2, TREE: 3, GRAPH: 4, TREE_DELTA: 5, BFS_LEVELS: 6, HASHMAP_GROUPS: 7, HEAP_NODES: 8, BTREE: 9 };
+
+// Split a snapshot into { kind, sections: [{ count, stride, data }] }.
+// Section data are subarrays of the original view (no copy).
+function readSnapshot(view) {
+    const kind = view[0];
+    const sectionCount = view[1];
+    const sections = [];
+    let pos = 2;
+    for (let s = 0; s < sectionCount; s++) {
+        const count = view[pos];
+        const stride = view[pos + 1];
+        const start = pos + 2;
+        const end = start + count * stride;
+        sections.push({ count, stride, data: view.subarray(start, end) });
+        pos = end;
+    }
+    return { kind, sections };
+}
+
+// Heap: a section of values in array order, a one-word section with the
+// arity (children per node), then a section of [x, y] per slot (the tree
+// layout, see tree_layout.h). Produces { values, arity, positions }; values
+// and positions are the Int32Array views as-is (positions null if absent).
+function decodeHeapSnapshot(view) {
+    const [values, arity, positions] = readSnapshot(view).sections;
+    return { values: values.data, arity: arity ? arity.data[0] : 2, positions: positions ? positions.data : null };
+}
+
+// Addressable heaps: one section of [handle, key, payload, parentHandle, side],
+// parents before children and children in order; parentHandle is -1 for a
+// root and side says which of the (up to two) heaps the node belongs to.
+// Produces { roots } with one nested { id, handle, value, payload, side,
+// children } tree per side, or null for an empty side.
+function decodeHeapNodesSnapshot(view) {
+    const { count, data } = readSnapshot(view).sections[0];
+    const byHandle = new Map();
+    const roots = [null, null];
+    for (let i = 0; i < count; i++) {
+        const o = 5 * i;
+        const handle = data[o];
+        const node = { id: "h" + handle, handle, value: data[o + 1], payload: data[o + 2], side: data[o + 4], children: [] };
+        byHandle.set(handle, node);
+        const parent = data[o + 3];
+        if (parent < 0) roots[data[o + 4]] = node;
+        else byHandle.get(parent).children.push(node);
+    }
+    return { roots };
+}
+
+// Hash map: a section of [key, psl] per slot of the table, then the same for
+// the previous table while a resize is in progress (empty otherwise). psl is
+// the slot's distance from the key's home slot, -1 for an empty slot.
+// Produces { table, size, resizing } with null for empty slots and
+// { key, psl } otherwise; resizing is null when no resize is running.
+function decodeHashMapSnapshot(view) {
+    const [current, previous] = readSnapshot(view).sections;
+    const decodeSlots = ({ count, data }) => {
+        const slots = new Array(count);
+        for (let i = 0; i < count; i++) {
+            const psl = data[2 * i + 1];
+            slots[i] = psl < 0 ? null : { key: data[2 * i], psl };
+        }
+        return slots;
+    };
+    return {
+        table: decodeSlots(current),
+        size: current.count,
+        resizing: previous.count > 0 ? decodeSlots(previous) : null,
+    };
+}
+
+// Swiss table: one section of [control, key] per slot, slots in groups of
+// SWISS_GROUP_WIDTH. A control byte is 0x80 for empty, 0xFE for deleted and
+// the key's 7-bit hash tag otherwise. Produces { groups, size } where each
+// group is an array of { state: "empty" | "deleted" | "full", tag, key }.
+const SWISS_GROUP_WIDTH = 16;
+
+function decodeSwissSnapshot(view) {
+    const { count, data } = readSnapshot(view).sections[0];
+    const groups = [];
+    for (let i = 0; i < count; i++) {
+        if (i % SWISS_GROUP_WIDTH === 0) groups.push([]);
+        const ctrl = data[2 * i];
+        const state = ctrl === 0x80 ? "empty" : ctrl === 0xFE ? "deleted" : "full";
+        groups[groups.length - 1].push({ state, tag: ctrl, key: data[2 * i + 1] });
+    }
+    return { groups, size: count };
+}
+
+// Multiway tree (B+ tree, static Eytzinger index): one section of
+// [id, parentId, leaf, count, keys...] with keys padded to the node width,
+// parents before children and children in key order. Produces { root, width }
+// where root is a nested { id, leaf, keys, children } object for d3.hierarchy
+// (null for an empty tree) and width is the keys a node can hold.
+function decodeBTreeSnapshot(view) {
+    const { count, stride, data } = readSnapshot(view).sections[0];
+    const width = stride - 4;
+    const byId = new Map();
+    let root = null;
+    for (let i = 0; i < count; i++) {
+        const o = stride * i;
+        const node = { id: data[o], leaf: data[o + 2] === 1, keys: Array.from(data.subarray(o + 4, o + 4 + data[o + 3])) };
+        byId.set(node.id, node);
+        const parentId = data[o + 1];
+        if (parentId < 0) {
+            root = node;
+        } else {
+            const parent = byId.get(parentId);
+            if (!parent.children) parent.children = [];
+            parent.children.push(node);
+        }
+    }
+    return { root, width };
+}
+
+// Tree delta opcodes (see tree.cpp). Records are [op, a, b, c, d]:
+//   ADD    id, value, parentId (-1 = root), side (0 left / 1 right)
+//   REMOVE id                 node spliced out, its only child takes its place
+//   ROTATE pivotId, right     right = 1 for a right rotation
+//   VALUE  id, value
+//   RESET                     tree emptied
+//   TAG    id, tag            red-black color (1 = red) or treap priority
+const TreeDeltaOp = { ADD: 1, REMOVE: 2, ROTATE: 3, VALUE: 4, RESET: 5, TAG: 6 };
+
+// Tree deltas: one section of 5-word records, returned as-is (Int32Array view),
+// then the positions of the nodes they moved (see decodeTreeLayout).
+function decodeTreeDeltaSnapshot(view) {
+    const { count, data } = readSnapshot(view).sections[0];
+    return { count, data };
+}
+
+// Node positions from a tree snapshot or delta: the second section, [id, x, y]
+// in pixels (laid out by tree_layout.h). Returned as-is; count is 0 if absent.
+function decodeTreeLayout(view) {
+    const layout = readSnapshot(view).sections[1];
+    return layout ? { count: layout.count, data: layout.data } : { count: 0, data: new Int32Array(0) };
+}
+
+// Level BFS: one section of [node, level, parent] grouped by level (the start
+// node is level 0 and its own parent). Returned as-is (Int32Array view).
+function decodeBfsLevelsSnapshot(view) {
+    const { count, data } = readSnapshot(view).sections[0];
+    return { count, data };
+}
+
+// Graph: a section of node ids followed by a section of [source, target, weight].
+function decodeGraphSnapshot(view) {
+    const [nodeSec, linkSec] = readSnapshot(view).sections;
+
+    const nodes = new Array(nodeSec.count);
+    for (let i = 0; i < nodeSec.count; i++) {
+        nodes[i] = { id: nodeSec.data[i] };
+    }
+
+    const links = new Array(linkSec.count);
+    for (let i = 0; i < linkSec.count; i++) {
+        const o = 3 * i;
+        links[i] = { source: linkSec.data[o], target: linkSec.data[o + 1], weight: linkSec.data[o + 2] };
+    }
+    return { nodes, links };
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <vector>
+#include "tree_core.h"
+
+// Splay tree on the shared node pool (tree_core.h). Every access rotates the
+// node it lands on up to the root (zig, zig-zig, zig-zag), so recently and
+// frequently used keys sit near the top. No balance state is stored; the
+// amortized cost is O(log n), and on skewed access it drops toward the
+// entropy of the access pattern. The catch: search changes the tree, so it
+// reports rotations and commits like an update.
+//
+// Bottom-up splaying along the recorded path, so every change is an ordinary
+// rotation delta the viewer can replay.
+template <class Trace>
+class SplayTree : public TreeBase<Trace> {
+private:
+    using Base = TreeBase<Trace>;
+    using Base::root;
+    using Base::sink;
+    using Base::path;
+    using Base::rotateUp;
+
+    // Rotates x (whose ancestors are path[keep..]) up until only path[0..keep)
+    // is left above it. keep = 0 splays to the root.
+    void splay(Node* x, size_t keep = 0) {
+        while (path.size() > keep) {
+            Node* p = path.back();
+            if (path.size() == keep + 1) {
+                // zig: p is the last one to pass
+                rotateUp(x, p, keep > 0 ? path[keep - 1] : nullptr);
+                path.pop_back();
+                break;
+            }
+            Node* g = path[path.size() - 2];
+            Node* above = path.size() > 2 ? path[path.size() - 3] : nullptr;
+            if ((g->left == p) == (p->left == x)) {
+                // zig-zig: grandparent first, then parent
+                rotateUp(p, g, above);
+                rotateUp(x, p, above);
+            } else {
+                // zig-zag: x past its parent, then past the grandparent
+                rotateUp(x, p, g);
+                rotateUp(x, g, above);
+            }
+            path.pop_back();
+            path.pop_back();
+        }
+    }
+
+    // Walks to value, recording the path; returns the node or nullptr. With
+    // visited, the ids on the way are collected for the search highlight.
+    Node* find(int value, std::vector<int>* visited = nullptr) {
+        path.clear();
+        Node* cur = root;
+        while (cur) {
+            if (visited) visited->push_back(cur->id);
+            if (cur->data == value) return cur;
+            path.push_back(cur);
+            cur = value < cur->data ? cur->left : cur->right;
+        }
+        return nullptr;
+    }
+
+    // A miss splays the last node visited instead, as the textbook does, so
+    // repeated misses around the same key get cheap too
+    void splayFound(Node* found) {
+        if (found) {
+            splay(found);
+        } else if (!path.empty()) {
+            Node* last = path.back();
+            path.pop_back();
+            splay(last);
+        }
+    }
+
+    void insertNode(int value) {
+        Node* found = find(value);
+        if (found) {
+            splay(found); // Duplicate keys not allowed, but it still counts as an access
+            return;
+        }
+        Node* parent = path.empty() ? nullptr : path.back();
+        Node* leaf = this->attachLeaf(parent, parent && value > parent->data, value);
+        splay(leaf);
+    }
+
+    void removeNode(int value) {
+        Node* node = find(value);
+        splayFound(node);
+        if (!node) return;
+
+        // node is the root now
+        if (!node->left || !node->right) {
+            path.clear();
+            this->splice(nullptr, node);
+            return;
+        }
+
+        // Splay the predecessor up under the root; it then has no right
+        // child, so it can hand its value over and be spliced out
+        path.assign(1, node);
+        Node* pred = node->left;
+        while (pred->right) {
+            path.push_back(pred);
+            pred = pred->right;
+        }
+        splay(pred, 1);
+
+        node->data = pred->data;
+        if constexpr (Trace::coarse) sink->onValueChanged(node->id, node->data);
+        this->splice(node, pred);
+    }
+
+public:
+    explicit SplayTree(TreeSink* s = &nullTreeSink) : Base(s) {}
+
+    void insert(int value) {
+        insertNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    void remove(int value) {
+        removeNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    // Splays the key (or the last node on the way) to the root
+    bool search(int value) {
+        if constexpr (Trace::coarse) {
+            std::vector<int> visited;
+            Node* found = find(value, &visited);
+            sink->onSearchPath(visited);
+            splayFound(found);
+            sink->onCommit(root, found ? "Splayed" : "Not Found");
+            return found != nullptr;
+        } else {
+            Node* found = find(value);
+            splayFound(found);
+            return found != nullptr;
+        }
+    }
+
+    // Merges in n values and rebuilds balanced in O(n), rendering once.
+    // Returns how many keys were new.
+    int insertBulk(const int* values, size_t n) {
+        size_t existing;
+        std::vector<int> merged = this->mergeKeys(values, n, existing);
+        this->rebuildFrom(merged);
+
+        if constexpr (Trace::coarse) sink->onCommit(root, "Bulk Loaded");
+        return static_cast<int>(merged.size() - existing);
+    }
+};
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "trace.h"
+#include "hashmap_core.h"
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Set bits of a group comparison, one per matching slot. NEON has no
+// movemask, so its masks carry 4 bits per slot (shift 2); everything else
+// uses 1 bit per slot.
+struct GroupMask {
+    uint64_t bits;
+    int shift;
+
+    bool any() const { return bits != 0; }
+
+    // Pops the lowest matching slot (0..15)
+    int next() {
+        int slot = __builtin_ctzll(bits) >> shift;
+        bits &= bits - 1;
+        return slot;
+    }
+};
+
+// 16 control bytes compared at once: WASM SIMD128, SSE2 or NEON when the
+// build has them, a byte loop otherwise
+struct ControlGroup {
+    static constexpr size_t WIDTH = 16;
+
+    // Slots whose control byte equals b
+    static GroupMask match(const uint8_t* ctrl, uint8_t b) {
+#if defined(__wasm_simd128__)
+        v128_t group = wasm_v128_load(ctrl);
+        return {static_cast<uint32_t>(wasm_i8x16_bitmask(wasm_i8x16_eq(group, wasm_i8x16_splat(static_cast<int8_t>(b))))), 0};
+#elif defined(__SSE2__) || defined(_M_X64)
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        __m128i eq = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(b)));
+        return {static_cast<uint32_t>(_mm_movemask_epi8(eq)), 0};
+#elif defined(__ARM_NEON)
+        uint8x16_t eq = vceqq_u8(vld1q_u8(ctrl), vdupq_n_u8(b));
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        return {nibbles & 0x8888888888888888ULL, 2};
+#else
+        uint64_t bits = 0;
+        for (size_t i = 0; i < WIDTH; i++) bits |= uint64_t(ctrl[i] == b) << i;
+        return {bits, 0};
+#endif
+    }
+
+    // Slots that are EMPTY or DELETED (control byte has its top bit set)
+    static GroupMask matchFree(const uint8_t* ctrl) {
+#if defined(__wasm_simd128__)
+        return {static_cast<uint32_t>(wasm_i8x16_bitmask(wasm_v128_load(ctrl))), 0};
+#elif defined(__SSE2__) || defined(_M_X64)
+        return {static_cast<uint32_t>(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))), 0};
+#elif defined(__ARM_NEON)
+        uint8x16_t top = vcltq_s8(vreinterpretq_s8_u8(vld1q_u8(ctrl)), vdupq_n_s8(0));
+        uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(top), 4)), 0);
+        return {nibbles & 0x8888888888888888ULL, 2};
+#else
+        uint64_t bits = 0;
+        for (size_t i = 0; i < WIDTH; i++) bits |= uint64_t(ctrl[i] >> 7) << i;
+        return {bits, 0};
+#endif
+    }
+};
+
+// Swiss-table style open addressing, the second engine behind hashmap.html.
+// Trace is NoTrace / CoarseTrace / FullTrace (see trace.h)
+//
+// Each slot has a control byte: CTRL_EMPTY, CTRL_DELETED, or the low 7 bits
+// of the key's hash (its tag) when full. Slots come in aligned groups of 16;
+// a lookup picks a group from the rest of the hash and compares all 16
+// control bytes against the tag in one SIMD instruction, so keys are only
+// touched on a tag match (about 1 in 128 for a wrong key). Groups are probed
+// in triangular steps, which visits every group once for a power-of-two count.
+//
+// A search stops at the first group with an EMPTY byte. Removal leaves EMPTY
+// when the slot's group still has one (no probe can have passed it) and a
+// tombstone otherwise; tombstones are cleared by the next rehash, which runs
+// once used slots reach 7/8 of the table.
+template <class Trace>
+class SwissTable {
+public:
+    static constexpr uint8_t CTRL_EMPTY = 0x80;
+    static constexpr uint8_t CTRL_DELETED = 0xFE;
+
+private:
+    static constexpr size_t GROUP = ControlGroup::WIDTH;
+
+    std::vector<uint8_t> control;
+    std::vector<int> keys;
+    size_t groupMask = 0;
+    size_t count = 0;
+    size_t tombstones = 0;
+    HashMapSink* sink;
+
+    static uint8_t tagOf(uint32_t h) { return h & 0x7F; }
+    size_t homeGroup(uint32_t h) const { return (h >> 7) & groupMask; }
+
+    void notify() {
+        if constexpr (Trace::coarse) sink->onGroupSnapshot(control, keys);
+    }
+
+    // Helper to find key; returns the slot or -1
+    int find(int key) const {
+        uint32_t h = mixHash(key);
+        uint8_t tag = tagOf(h);
+        size_t g = homeGroup(h);
+        for (size_t step = 1; step <= groupMask + 1; step++) {
+            const uint8_t* ctrl = &control[g * GROUP];
+            for (GroupMask m = ControlGroup::match(ctrl, tag); m.any();) {
+                size_t slot = g * GROUP + m.next();
+                if (keys[slot] == key) return static_cast<int>(slot);
+            }
+            if (ControlGroup::match(ctrl, CTRL_EMPTY).any()) return -1;
+            g = (g + step) & groupMask;
+        }
+        return -1;
+    }
+
+    // First EMPTY or DELETED slot on key's probe sequence (there always is one)
+    size_t findFree(uint32_t h) const {
+        size_t g = homeGroup(h);
+        for (size_t step = 1;; step++) {
+            GroupMask m = ControlGroup::matchFree(&control[g * GROUP]);
+            if (m.any()) return g * GROUP + m.next();
+            g = (g + step) & groupMask;
+        }
+    }
+
+    void placeNew(int key) {
+        uint32_t h = mixHash(key);
+        size_t slot = findFree(h);
+        if (control[slot] == CTRL_DELETED) tombstones--;
+        control[slot] = tagOf(h);
+        keys[slot] = key;
+        count++;
+    }
+
+    void allocate(size_t capacity) {
+        size_t groups = 1;
+        while (groups * GROUP < capacity) groups <<= 1;
+        control.assign(groups * GROUP, CTRL_EMPTY);
+        keys.assign(groups * GROUP, 0);
+        groupMask = groups - 1;
+        count = tombstones = 0;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<uint8_t> oldControl;
+        std::vector<int> oldKeys;
+        oldControl.swap(control);
+        oldKeys.swap(keys);
+
+        allocate(capacity);
+        for (size_t i = 0; i < oldControl.size(); i++) {
+            if (!(oldControl[i] & 0x80)) placeNew(oldKeys[i]);
+        }
+    }
+
+    // Keeps used slots (keys + tombstones) at or under 7/8 of the table.
+    // The rehash grows until the live keys fit in 7/16, so a table that is
+    // mostly tombstones is just cleaned up at the same size.
+    void reserveFor(size_t extra) {
+        if ((count + tombstones + extra) * 8 <= control.size() * 7) return;
+        size_t capacity = control.size();
+        while ((count + extra) * 16 > capacity * 7) capacity <<= 1;
+        rehash(capacity);
+    }
+
+    bool insertSilent(int key) {
+        if (find(key) != -1) return false; // Already exists
+        reserveFor(1);
+        placeNew(key);
+        return true;
+    }
+
+public:
+    // capacity is rounded up to a power-of-two number of 16-slot groups
+    explicit SwissTable(int capacity, HashMapSink* sk = &nullHashMapSink) : sink(sk) {
+        allocate(capacity > 0 ? static_cast<size_t>(capacity) : 0);
+        notify();
+    }
+
+    // Empties the table, keeping its current capacity
+    void clear() {
+        allocate(control.size());
+        notify();
+    }
+
+    // Returns false if key was already present
+    bool insert(int key) {
+        if (!insertSilent(key)) return false;
+        notify();
+        return true;
+    }
+
+    // Inserts n keys and renders once; returns how many were new
+    int insertBulk(const int* batch, size_t n) {
+        reserveFor(n);
+        int inserted = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (find(batch[i]) != -1) continue;
+            placeNew(batch[i]);
+            inserted++;
+        }
+        notify();
+        return inserted;
+    }
+
+    bool contains(int key) const { return find(key) != -1; }
+
+    // Looks key up and highlights its slot
+    bool search(int key) {
+        int slot = find(key);
+        if (slot == -1) return false;
+        if constexpr (Trace::coarse) sink->onFound(slot, false);
+        return true;
+    }
+
+    bool remove(int key) {
+        int slot = find(key);
+        if (slot == -1) return false;
+
+        size_t groupStart = slot / GROUP * GROUP;
+        if (ControlGroup::match(&control[groupStart], CTRL_EMPTY).any()) {
+            control[slot] = CTRL_EMPTY;
+        } else {
+            control[slot] = CTRL_DELETED;
+            tombstones++;
+        }
+        count--;
+        notify();
+        return true;
+    }
+
+    int capacity() const { return static_cast<int>(control.size()); }
+    size_t size() const { return count; }
+
+    // Raw control bytes and keys (a key is only meaningful in a full slot)
+    const std::vector<uint8_t>& controls() const { return control; }
+    const std::vector<int>& slots() const { return keys; }
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+// --- Tracing policies ---
+// Engines are templated on one of these. Every sink call is wrapped in
+// `if constexpr` on the policy, so levels that are off compile to nothing:
+// no virtual call, no argument building, no allocation.
+//
+//   NoTrace     - production / benchmark builds, no events at all
+//   CoarseTrace - one event per public operation (final snapshot, search result)
+//   FullTrace   - step-by-step events for the teaching UI (rotations, visits, relaxations)
+
+struct NoTrace {
+    static constexpr bool coarse = false;
+    static constexpr bool full = false;
+};
+
+struct CoarseTrace {
+    static constexpr bool coarse = true;
+    static constexpr bool full = false;
+};
+
+struct FullTrace {
+    static constexpr bool coarse = true;
+    static constexpr bool full = true;
+};
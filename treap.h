@@ -0,0 +1,135 @@
+#pragma once
+
+#include <vector>
+#include <random>
+#include "tree_core.h"
+
+// Treap on the shared node pool (tree_core.h): a BST on keys that is also a
+// max-heap on random priorities (Node::tag). The random priorities make the
+// shape that of a random insertion order whatever order keys really arrive
+// in, so depth is O(log n) expected with no balance bookkeeping at all.
+//
+// Insert adds a leaf and rotates it up while it outranks its parent; remove
+// rotates the node down toward its higher-priority child until it can be
+// spliced. Both average under two rotations. The generator is seeded, so a
+// given operation sequence always builds the same tree.
+template <class Trace>
+class Treap : public TreeBase<Trace> {
+private:
+    using Base = TreeBase<Trace>;
+    using Base::root;
+    using Base::sink;
+    using Base::path;
+    using Base::setTag;
+
+    std::mt19937 rng{12345};
+
+    int randomPriority() { return static_cast<int>(rng() >> 1); }
+
+    void insertNode(int value) {
+        path.clear();
+        Node* parent = nullptr;
+        Node* cur = root;
+        bool right = false;
+        while (cur) {
+            if (value == cur->data) return; // Duplicate keys not allowed
+            path.push_back(cur);
+            parent = cur;
+            right = value > cur->data;
+            cur = right ? cur->right : cur->left;
+        }
+
+        Node* leaf = this->attachLeaf(parent, right, value);
+        setTag(leaf, randomPriority());
+
+        // Rotate up until the parent outranks it
+        while (!path.empty() && path.back()->tag < leaf->tag) {
+            Node* p = path.back();
+            path.pop_back();
+            this->rotateUp(leaf, p, path.empty() ? nullptr : path.back());
+        }
+    }
+
+    void removeNode(int value) {
+        path.clear();
+        Node* node = root;
+        while (node && node->data != value) {
+            path.push_back(node);
+            node = value < node->data ? node->left : node->right;
+        }
+        if (!node) return;
+
+        // Rotate the higher-priority child above it until it has one child left
+        while (node->left && node->right) {
+            Node* child = node->left->tag > node->right->tag ? node->left : node->right;
+            this->rotateUp(child, node, path.empty() ? nullptr : path.back());
+            path.push_back(child);
+        }
+        this->splice(path.empty() ? nullptr : path.back(), node);
+    }
+
+    // Builds the treap over sorted keys in O(n): each new (largest) key
+    // joins the right spine, below the last node that outranks it
+    void buildCartesian(const std::vector<int>& sorted) {
+        std::vector<Node*> spine;
+        for (int key : sorted) {
+            Node* node = this->newNode(key);
+            node->tag = randomPriority();
+            Node* below = nullptr;
+            while (!spine.empty() && spine.back()->tag < node->tag) {
+                below = spine.back();
+                spine.pop_back();
+            }
+            node->left = below;
+            if (!spine.empty()) spine.back()->right = node;
+            spine.push_back(node);
+        }
+        root = spine.empty() ? nullptr : spine.front();
+        this->findRightmost();
+        this->recountSizes();
+    }
+
+    // Reports the whole tree as adds in pre-order, each with its priority
+    void announce() {
+        struct Pending { Node* node; int parentId; bool right; };
+        std::vector<Pending> stack;
+        if (root) stack.push_back({root, -1, false});
+        while (!stack.empty()) {
+            Pending p = stack.back();
+            stack.pop_back();
+            sink->onNodeAdded(p.node->id, p.node->data, p.parentId, p.right);
+            sink->onTagChanged(p.node->id, p.node->tag);
+            if (p.node->right) stack.push_back({p.node->right, p.node->id, true});
+            if (p.node->left) stack.push_back({p.node->left, p.node->id, false});
+        }
+    }
+
+public:
+    explicit Treap(TreeSink* s = &nullTreeSink) : Base(s) {}
+
+    void insert(int value) {
+        insertNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    void remove(int value) {
+        removeNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    // Merges in n values and rebuilds in O(n) with fresh priorities,
+    // rendering once. Returns how many keys were new.
+    int insertBulk(const int* values, size_t n) {
+        size_t existing;
+        std::vector<int> merged = this->mergeKeys(values, n, existing);
+
+        this->resetNodes();
+        buildCartesian(merged);
+        if constexpr (Trace::coarse) {
+            sink->onReset();
+            announce();
+            sink->onCommit(root, "Bulk Loaded");
+        }
+        return static_cast<int>(merged.size() - existing);
+    }
+};
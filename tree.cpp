@@ -4,316 +4,378 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "tree_core.h"
+#include "red_black_tree.h"
+#include "treap.h"
+#include "splay_tree.h"
+#include "bplus_tree.h"
+#include "eytzinger_index.h"
+#include "persistent_tree.h"
+#include "tree_layout.h"
+#include "snapshot.h"
 
 using namespace emscripten;
 
-struct Node {
-    int data;
-    Node* left;
-    Node* right;
-    int id; // Unique ID for D3
-    int height;
+// File-local up to the bindings: graph.cpp has its own logEvent, and the
+// engine enums and instances of every page would clash in a shared link.
+namespace {
 
-    Node(int val, int nodeId) : data(val), left(nullptr), right(nullptr), id(nodeId), height(1) {}
-};
+// --- Web bindings for the tree engine (logic lives in tree_core.h) ---
 
-Node* bstRoot = nullptr;
-int nextId = 0;
-
-// Helper to serialize tree to JS object
-// Helper to serialize tree to JS object
-val getTreeData(Node* node) {
-    if (!node) return val::null();
-
-    val obj = val::object();
-    obj.set("id", node->id);
-    obj.set("value", node->data);
-    
-    val children = val::array();
-    if (node->left) children.call<void>("push", getTreeData(node->left));
-    if (node->right) children.call<void>("push", getTreeData(node->right));
-    
-    if (node->left || node->right) {
-        obj.set("children", children);
-    }
+SnapshotWriter treeSnapshot;
 
-    return obj;
-}
+// Node positions for the binary views (tree_layout.h), in tree.html's
+// spacing: 50px between siblings, 70px per level. Fed the same deltas as
+// the page, so an edit only re-lays out the spine it touched.
+TreeLayout treeLayout(50, 70);
 
-// Helper to log events to JS
-void logEvent(std::string type, val data, std::string message) {
-    val::global("handleEvent").call<void>("call", val::undefined(), type, data, message);
+// Helper to append the layout as an [id, x, y] section: every node, or
+// only the ones the last update moved
+void writeTreeLayout(SnapshotWriter& out, bool all) {
+    const std::vector<int>& moved = treeLayout.update();
+    out.beginSection(3);
+    if (all) {
+        treeLayout.forEachNode([&](int id) { out.put(id, treeLayout.x(id), treeLayout.y(id)); });
+    } else {
+        for (int id : moved) out.put(id, treeLayout.x(id), treeLayout.y(id));
+    }
+    out.endSection();
 }
 
-void updateBSTVisualization() {
-    val treeData = getTreeData(bstRoot);
-    logEvent("snapshot", treeData, "Tree Updated");
+// Pre-order [id, value, parentId, side, tag] records; side is -1 for the root, 0 left, 1 right.
+// Explicit stack, since a plain BST over sorted input is one long chain.
+void writeTreeNodes(const Node* root) {
+    struct Pending { const Node* node; int parentId; int side; };
+    std::vector<Pending> stack;
+    if (root) stack.push_back({root, -1, -1});
+    while (!stack.empty()) {
+        Pending p = stack.back();
+        stack.pop_back();
+        treeSnapshot.put(p.node->id, p.node->data, p.parentId, p.side, p.node->tag);
+        // Right first so the left subtree comes out first
+        if (p.node->right) stack.push_back({p.node->right, p.node->id, 1});
+        if (p.node->left) stack.push_back({p.node->left, p.node->id, 0});
+    }
 }
 
-// --- AVL Helpers ---
-bool useAVL = false;
-
-int getHeight(Node* N) {
-    if (N == nullptr) return 0;
-    return N->height;
+// Helper to serialize tree into the shared snapshot buffer (decoded by
+// snapshot.js), with every node's position after it
+val getTreeData(const Node* node) {
+    treeSnapshot.begin(SNAPSHOT_TREE);
+    treeSnapshot.beginSection(5);
+    writeTreeNodes(node);
+    treeSnapshot.endSection();
+    writeTreeLayout(treeSnapshot, true);
+    return treeSnapshot.view();
 }
 
-int max(int a, int b) {
-    return (a > b) ? a : b;
+// Helper to log events to JS
+void logEvent(std::string type, val data, std::string message) {
+    val::global("handleEvent").call<void>("call", val::undefined(), type, data, message);
 }
 
-Node* rightRotate(Node* y) {
-    // Highlight nodes involved
-    val ids = val::array();
-    ids.call<void>("push", y->id);
-    if (y->left) ids.call<void>("push", y->left->id);
-    logEvent("highlight", ids, "Right Rotating...");
-
-    Node* x = y->left;
-    Node* T2 = x->right;
+// Delta opcodes (mirrored by TreeDeltaOp in snapshot.js)
+enum TreeDeltaOp { DELTA_ADD = 1, DELTA_REMOVE = 2, DELTA_ROTATE = 3, DELTA_VALUE = 4, DELTA_RESET = 5, DELTA_TAG = 6 };
+
+// A full snapshot replaces the deltas every RESYNC_INTERVAL operations, so
+// tree.html's copy can never drift for long
+const int RESYNC_INTERVAL = 64;
+
+// Forwards tree changes to tree.html. Deltas are batched into one
+// [op, a, b, c, d] buffer and shipped per step/commit, followed by the
+// positions of the nodes that moved, so an insert costs O(changes) to
+// publish instead of a walk over the whole tree.
+class WebTreeSink : public TreeSink {
+private:
+    SnapshotWriter deltas;
+    bool pending = false;
+    int commits = 0;
+
+    void push(int op, int a, int b = 0, int c = 0, int d = 0) {
+        if (!pending) {
+            deltas.begin(SNAPSHOT_TREE_DELTA);
+            deltas.beginSection(5);
+            pending = true;
+        }
+        deltas.put(op, a, b, c, d);
+    }
 
-    // Perform rotation
-    x->right = y;
-    y->left = T2;
+    void flush(const char* message) {
+        if (!pending) return;
+        deltas.endSection();
+        writeTreeLayout(deltas, false);
+        pending = false;
+        logEvent("delta", deltas.view(), message);
+    }
 
-    // Update heights
-    y->height = max(getHeight(y->left), getHeight(y->right)) + 1;
-    x->height = max(getHeight(x->left), getHeight(x->right)) + 1;
+public:
+    void onNodeAdded(int id, int value, int parentId, bool right) override {
+        push(DELTA_ADD, id, value, parentId, right ? 1 : 0);
+        treeLayout.add(id, parentId, right ? 1 : 0);
+    }
 
-    // Snapshot after rotation
-    logEvent("snapshot", getTreeData(bstRoot), "Rotated");
+    void onNodeRemoved(int id) override {
+        push(DELTA_REMOVE, id);
+        treeLayout.remove(id);
+    }
 
-    return x;
-}
+    void onRotated(int pivotId, bool right) override {
+        push(DELTA_ROTATE, pivotId, right ? 1 : 0);
+        treeLayout.rotate(pivotId, right);
+    }
 
-Node* leftRotate(Node* x) {
-    // Highlight nodes involved
-    val ids = val::array();
-    ids.call<void>("push", x->id);
-    if (x->right) ids.call<void>("push", x->right->id);
-    logEvent("highlight", ids, "Left Rotating...");
+    void onValueChanged(int id, int value) override {
+        push(DELTA_VALUE, id, value);
+    }
 
-    Node* y = x->right;
-    Node* T2 = y->left;
+    void onReset() override {
+        push(DELTA_RESET, 0);
+        treeLayout.clear();
+    }
 
-    // Perform rotation
-    y->left = x;
-    x->right = T2;
+    void onTagChanged(int id, int tag) override {
+        push(DELTA_TAG, id, tag);
+    }
 
-    // Update heights
-    x->height = max(getHeight(x->left), getHeight(x->right)) + 1;
-    y->height = max(getHeight(y->left), getHeight(y->right)) + 1;
+    void onRotate(int pivotId, int childId, bool right) override {
+        // Show the tree as it was before the rotation, then highlight
+        flush("Tree Updated");
+        val ids = val::array();
+        ids.call<void>("push", pivotId);
+        ids.call<void>("push", childId);
+        logEvent("highlight", ids, right ? "Right Rotating..." : "Left Rotating...");
+    }
 
-    // Snapshot after rotation
-    logEvent("snapshot", getTreeData(bstRoot), "Rotated");
+    void onStep(const char* message) override {
+        flush(message);
+    }
 
-    return y;
-}
+    void onCommit(const Node* root, const char* message) override {
+        if (++commits % RESYNC_INTERVAL == 0) {
+            pending = false;
+            logEvent("snapshot", getTreeData(root), message);
+        } else {
+            flush(message);
+        }
+    }
 
-int getBalance(Node* N) {
-    if (N == nullptr) return 0;
-    return getHeight(N->left) - getHeight(N->right);
-}
+    void onSearchPath(const std::vector<int>& path) override {
+        val js_path = val::array();
+        for (int id : path) {
+            js_path.call<void>("push", id);
+        }
+        val::global("highlightPath").call<void>("call", val::undefined(), js_path);
+    }
+};
 
-void inorderExtraction(Node* root, std::vector<int>& nodes) {
-    if (!root) return;
-    inorderExtraction(root->left, nodes);
-    nodes.push_back(root->data);
-    inorderExtraction(root->right, nodes);
-}
+WebTreeSink webTreeSink;
 
-void deleteTree(Node* node) {
-    if (!node) return;
-    deleteTree(node->left);
-    deleteTree(node->right);
-    delete node;
-}
+SnapshotWriter btreeSnapshot;
 
-extern "C" void insertBST(int value); // Forward declaration
-Node* insertRec(Node* node, int value); // Forward declaration
-
-void rebalanceBST() {
-    std::vector<int> nodes;
-    inorderExtraction(bstRoot, nodes);
-    
-    // Clear current tree
-    deleteTree(bstRoot);
-    bstRoot = nullptr;
-    nextId = 0;
-    
-    // Re-insert with AVL enabled
-    // We need to reset root and nextId, but we want to visualize the reconstruction?
-    // Or just show the final result? The user wants "rebalance".
-    // Let's just re-insert them one by one.
-    
-    // Note: insertBST calls updateBSTVisualization which logs a snapshot.
-    // This will create an animation of the tree being rebuilt balanced.
-    for (int val : nodes) {
-        bstRoot = insertRec(bstRoot, val);
-        updateBSTVisualization();
-    }
+// Helper to ship multiway records (B+ tree, static index) as a SNAPSHOT_BTREE
+val getBTreeData(const std::vector<int>& records, int stride) {
+    btreeSnapshot.begin(SNAPSHOT_BTREE);
+    btreeSnapshot.beginSection(stride);
+    for (int word : records) btreeSnapshot.put(word);
+    btreeSnapshot.endSection();
+    return btreeSnapshot.view();
 }
 
-extern "C" void setAVL(bool enable) {
-    useAVL = enable;
-    if (useAVL) {
-        rebalanceBST();
+// Multiway nodes have no binary deltas, so the B+ tree sends whole snapshots
+// ("btree" events); they are a few dozen nodes at the sizes the page shows
+class WebBTreeSink : public BTreeSink {
+public:
+    void onSnapshot(const std::vector<int>& records, int stride, const char* message) override {
+        logEvent("btree", getBTreeData(records, stride), message);
     }
-}
-
-// --- BST Operations ---
 
-Node* insertRec(Node* node, int value) {
-    if (!node) {
-        return new Node(value, nextId++);
-    }
-    if (value < node->data) {
-        node->left = insertRec(node->left, value);
-    } else if (value > node->data) {
-        node->right = insertRec(node->right, value);
-    } else {
-        return node; // Duplicate keys not allowed
+    void onSearchPath(const std::vector<int>& path) override {
+        webTreeSink.onSearchPath(path);
     }
+};
 
-    if (!useAVL) return node;
-
-    // Update height
-    node->height = 1 + max(getHeight(node->left), getHeight(node->right));
-
-    // Get balance factor
-    int balance = getBalance(node);
+WebBTreeSink webBTreeSink;
 
-    // Left Left Case
-    if (balance > 1 && value < node->left->data)
-        return rightRotate(node);
+// Engines selectable from tree.html (all share the insert/remove/search API)
+enum TreeEngine { ENGINE_BST = 0, ENGINE_RED_BLACK = 1, ENGINE_TREAP = 2, ENGINE_SPLAY = 3, ENGINE_BPLUS = 4, ENGINE_PERSISTENT = 5 };
 
-    // Right Right Case
-    if (balance < -1 && value > node->right->data)
-        return leftRotate(node);
+// The persistent tree keeps every version, so it ships the version being
+// shown as a full snapshot plus a "version" event for the history slider
+// (onVersion is defined below, after the engine it reads)
+class WebVersionSink : public VersionSink {
+public:
+    void onVersion(int version, const char* message) override;
 
-    // Left Right Case
-    if (balance > 1 && value > node->left->data) {
-        node->left = leftRotate(node->left);
-        return rightRotate(node);
+    void onSearchPath(const std::vector<int>& path) override {
+        webTreeSink.onSearchPath(path);
     }
+};
 
-    // Right Left Case
-    if (balance < -1 && value < node->right->data) {
-        node->right = rightRotate(node->right);
-        return leftRotate(node);
+WebVersionSink webVersionSink;
+
+// Keys per node on the page: small enough that splits and merges show up
+// after a handful of inserts (the benchmarks use 16, one cache line)
+const int PAGE_NODE_KEYS = 4;
+
+// The teaching UI wants every rotation step
+BST<FullTrace> bst(&webTreeSink);
+RedBlackTree<FullTrace> redBlackTree(&webTreeSink);
+Treap<FullTrace> treap(&webTreeSink);
+SplayTree<FullTrace> splayTree(&webTreeSink);
+BPlusTree<FullTrace, PAGE_NODE_KEYS> bplusTree(&webBTreeSink);
+PersistentTree<FullTrace> persistentTree(&webVersionSink);
+int treeEngine = ENGINE_BST;
+
+// Helper to run f on whichever engine is active
+template <class F>
+auto withTree(F f) {
+    switch (treeEngine) {
+    case ENGINE_RED_BLACK: return f(redBlackTree);
+    case ENGINE_TREAP: return f(treap);
+    case ENGINE_SPLAY: return f(splayTree);
+    case ENGINE_BPLUS: return f(bplusTree);
+    case ENGINE_PERSISTENT: return f(persistentTree);
+    default: return f(bst);
     }
+}
 
-    return node;
+// Moves the current keys over to the new engine, which bulk-loads them
+void setTreeEngine(int engine) {
+    std::vector<int> keys = withTree([](auto& t) { return t.keys(); });
+    withTree([](auto& t) { t.clear(); });
+    treeEngine = engine;
+    withTree([&](auto& t) { t.insertBulk(keys.data(), keys.size()); });
 }
 
-extern "C" void insertBST(int value) {
-    bstRoot = insertRec(bstRoot, value);
-    updateBSTVisualization();
+// Versions come whole, so the layout starts over from each one
+void WebVersionSink::onVersion(int version, const char* message) {
+    treeLayout.clear();
+    treeSnapshot.begin(SNAPSHOT_TREE);
+    treeSnapshot.beginSection(5);
+    persistentTree.forEachNode(version, [](int id, int value, int parentId, int side) {
+        treeSnapshot.put(id, value, parentId, side, 0);
+        treeLayout.add(id, parentId, side);
+    });
+    treeSnapshot.endSection();
+    writeTreeLayout(treeSnapshot, true);
+    logEvent("snapshot", treeSnapshot.view(), message);
+
+    val info = val::object();
+    info.set("version", version);
+    info.set("count", persistentTree.versionCount());
+    logEvent("version", info, message);
 }
 
-Node* minValueNode(Node* node) {
-    Node* current = node;
-    while (current && current->left != nullptr)
-        current = current->left;
-    return current;
+// mode: 0 = rebuild from sorted keys, 1 = Day-Stout-Warren rotations (animated).
+// The plain BST and the persistent tree have an AVL switch; the persistent
+// one always rebuilds, as a new version.
+void setAVL(bool enable, int mode) {
+    if (treeEngine == ENGINE_PERSISTENT) persistentTree.setAVL(enable);
+    else bst.setAVL(enable, static_cast<RebalanceMode>(mode));
 }
 
-Node* deleteRec(Node* root, int value) {
-    if (!root) return root;
+// Persistent engine only: shows version (0 = empty tree); false if there is none
+bool showTreeVersion(int version) {
+    return persistentTree.checkout(version);
+}
 
-    if (value < root->data) {
-        root->left = deleteRec(root->left, value);
-    } else if (value > root->data) {
-        root->right = deleteRec(root->right, value);
-    } else {
-        if (!root->left) {
-            Node* temp = root->right;
-            delete root;
-            return temp;
-        } else if (!root->right) {
-            Node* temp = root->left;
-            delete root;
-            return temp;
-        }
+void insertBST(int value) {
+    withTree([&](auto& t) { t.insert(value); });
+}
 
-        Node* temp = minValueNode(root->right);
-        root->data = temp->data;
-        root->right = deleteRec(root->right, temp->data);
-    }
-    
-    if (!useAVL) return root;
-    if (!root) return root; // Should not happen if we returned earlier, but safe check
+// Bulk load from an Int32Array; returns how many keys were new
+int insertBSTBulk(val values) {
+    std::vector<int> data = convertJSArrayToNumberVector<int>(values);
+    return withTree([&](auto& t) { return t.insertBulk(data.data(), data.size()); });
+}
 
-    // Update height
-    root->height = 1 + max(getHeight(root->left), getHeight(root->right));
+void deleteBST(int value) {
+    withTree([&](auto& t) { t.remove(value); });
+}
 
-    // Get balance factor
-    int balance = getBalance(root);
+void searchBST(int value) {
+    withTree([&](auto& t) { t.search(value); });
+}
 
-    // Left Left Case
-    if (balance > 1 && getBalance(root->left) >= 0)
-        return rightRotate(root);
+void clearBST() {
+    withTree([](auto& t) { t.clear(); });
+}
 
-    // Left Right Case
-    if (balance > 1 && getBalance(root->left) < 0) {
-        root->left = leftRotate(root->left);
-        return rightRotate(root);
-    }
+// --- Order statistics (Node::size, O(depth) on the binary engines) ---
 
-    // Right Right Case
-    if (balance < -1 && getBalance(root->right) <= 0)
-        return leftRotate(root);
+int rankBST(int value) {
+    return withTree([&](auto& t) { return static_cast<int>(t.rank(value)); });
+}
 
-    // Right Left Case
-    if (balance < -1 && getBalance(root->right) > 0) {
-        root->right = rightRotate(root->right);
-        return leftRotate(root);
-    }
+// The index-th smallest key (from 0), or null
+val selectBST(int index) {
+    int key = 0;
+    bool found = index >= 0 && withTree([&](auto& t) { return t.select(index, key); });
+    return found ? val(key) : val::null();
+}
 
-    return root;
+int countRangeBST(int lo, int hi) {
+    return withTree([&](auto& t) { return static_cast<int>(t.countRange(lo, hi)); });
 }
 
-extern "C" void deleteBST(int value) {
-    bstRoot = deleteRec(bstRoot, value);
-    updateBSTVisualization();
+// Reused between scans
+std::vector<int> rangeResult;
+
+// Keys in [lo, hi] as one Int32Array over the WASM heap. Like the snapshot
+// views it is only valid until the next call into the module.
+val rangeScanBST(int lo, int hi) {
+    rangeResult.clear();
+    withTree([&](auto& t) { t.rangeScan(lo, hi, rangeResult); });
+    return val(typed_memory_view(rangeResult.size(), rangeResult.data()));
 }
 
-void searchRec(Node* node, int value, std::vector<int>& path) {
-    if (!node) return;
-    
-    path.push_back(node->id);
-    
-    if (node->data == value) return;
-    
-    if (value < node->data) {
-        searchRec(node->left, value, path);
-    } else {
-        searchRec(node->right, value, path);
-    }
+// Read-only snapshot of the current keys as a static Eytzinger-layout
+// B-tree, drawn with the same multiway view ("static" event)
+EytzingerIndex<PAGE_NODE_KEYS> staticIndex;
+
+void buildStaticSnapshot() {
+    staticIndex.build(withTree([](auto& t) { return t.keys(); }));
+    logEvent("static", getBTreeData(staticIndex.records(), EytzingerIndex<PAGE_NODE_KEYS>::RECORD_STRIDE), "Static Snapshot");
 }
 
-extern "C" void searchBST(int value) {
-    std::vector<int> path;
-    searchRec(bstRoot, value, path);
-    
-    val js_path = val::array();
-    for (int id : path) {
-        js_path.call<void>("push", id);
-    }
-    
-    val::global("highlightPath").call<void>("call", val::undefined(), js_path);
+// Searches the static snapshot, highlighting the blocks visited
+bool searchStaticSnapshot(int value) {
+    std::vector<int> visited;
+    bool found = staticIndex.contains(value, &visited);
+    webTreeSink.onSearchPath(visited);
+    return found;
 }
 
-extern "C" void clearBST() {
-    bstRoot = nullptr; 
-    nextId = 0;
-    updateBSTVisualization();
+// { live, slots, bytes, rotations } for the readout: nodes in the tree, ids
+// handed out since the last clear, bytes held by the node pool, and rotations
+// the active engine has done so far
+val treeMemoryUsage() {
+    val usage = val::object();
+    withTree([&](auto& t) {
+        usage.set("live", static_cast<double>(t.liveNodes()));
+        usage.set("slots", static_cast<double>(t.nodeSlots()));
+        usage.set("bytes", static_cast<double>(t.reservedBytes()));
+        usage.set("rotations", static_cast<double>(t.rotations()));
+    });
+    return usage;
 }
 
+} // namespace
+
 EMSCRIPTEN_BINDINGS(tree_module) {
     function("insertBST", &insertBST);
     function("deleteBST", &deleteBST);
     function("searchBST", &searchBST);
     function("clearBST", &clearBST);
     function("setAVL", &setAVL);
+    function("setTreeEngine", &setTreeEngine);
+    function("insertBSTBulk", &insertBSTBulk);
+    function("rankBST", &rankBST);
+    function("selectBST", &selectBST);
+    function("countRangeBST", &countRangeBST);
+    function("rangeScanBST", &rangeScanBST);
+    function("buildStaticSnapshot", &buildStaticSnapshot);
+    function("searchStaticSnapshot", &searchStaticSnapshot);
+    function("treeMemoryUsage", &treeMemoryUsage);
+    function("showTreeVersion", &showTreeVersion);
 }
@@ -0,0 +1,698 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include "trace.h"
+#include "node_pool.h"
+
+// Nodes come from the tree's SlabPool (node_pool.h); id is the pool slot, so
+// ids are unique among live nodes and freed ones get reused
+struct Node {
+    int data = 0;
+    int id = 0; // Unique ID for D3
+    Node* left = nullptr;
+    Node* right = nullptr;
+    int height = 1; // AVL only
+    int tag = 0;    // per-engine bookkeeping: red-black color, treap priority
+    int size = 1;   // nodes in this subtree, for rank / select
+};
+
+// --- Tree events ---
+// Structural changes are reported as deltas keyed on Node::id, so a viewer can
+// keep its own copy of the tree up to date without re-reading it. The root is
+// handed over at the end of every operation for the occasional full resync.
+// Default methods do nothing, so a plain TreeSink is the no-op sink.
+class TreeSink {
+public:
+    virtual ~TreeSink() = default;
+
+    // --- Deltas ---
+    // New leaf under parentId (-1 for the root); right = attached as right child
+    virtual void onNodeAdded(int id, int value, int parentId, bool right) {}
+    // Node with at most one child spliced out; its child (if any) takes its place
+    virtual void onNodeRemoved(int id) {}
+    // Rotation around pivotId (right = right rotation: its left child moves up)
+    virtual void onRotated(int pivotId, bool right) {}
+    virtual void onValueChanged(int id, int value) {}
+    // Node::tag changed (red-black recolor, treap priority on a new node)
+    virtual void onTagChanged(int id, int tag) {}
+    // Tree emptied (clear, or start of a rebuild)
+    virtual void onReset() {}
+
+    // About to rotate pivot with its child (right = right rotation), for highlighting
+    virtual void onRotate(int pivotId, int childId, bool right) {}
+    // Intermediate animation frame: the deltas since the last step/commit
+    virtual void onStep(const char* message) {}
+    // End of a public operation
+    virtual void onCommit(const Node* root, const char* message) {}
+    // Ids visited by a search, root first
+    virtual void onSearchPath(const std::vector<int>& path) {}
+};
+
+inline TreeSink nullTreeSink;
+
+// How setAVL(true) rebalances the existing tree
+//   Rebuild - flatten to sorted keys and build a perfect tree in O(n); one
+//             commit of deltas (reset + adds), ids start over
+//   DSW     - Day-Stout-Warren in place: rotate into a right vine, then
+//             compress it with left rotations, O(n) and no allocation. Nodes
+//             keep their ids and every move is a rotation delta, with an
+//             animation step per phase (FullTrace).
+enum class RebalanceMode { Rebuild = 0, DSW = 1 };
+
+// --- Shared tree machinery ---
+// Node storage, rotations and the bits every engine reports the same way.
+// The engines (BST/AVL below, RedBlackTree, Treap, SplayTree) derive from it
+// and share the insert / remove / search / insertBulk / clear API, so
+// tree.cpp and the benchmarks can swap them freely.
+//
+// Everything is iterative: engines walk down keeping the root-to-node path
+// in `path` and fix things up on the way back through it, so a degenerate
+// tree can be any depth. attachLeaf and splice rely on that: path must hold
+// exactly the ancestors of the leaf / spliced node (root first) when they
+// are called, since those are the subtree sizes that change.
+//
+// Node::size makes rank / select / countRange O(depth). Rotations keep it
+// right like the AVL heights; an engine that changes the tree some other way
+// recounts, or marks sizes stale so the next query recounts.
+//
+// Trace is NoTrace / CoarseTrace / FullTrace (see trace.h). Deltas and commits
+// are coarse; rotation highlights and intermediate animation steps are FullTrace only.
+template <class Trace>
+class TreeBase {
+protected:
+    Node* root = nullptr;
+    Node* rightmost = nullptr; // largest key, kept up to date by attach/splice
+    SlabPool<Node> pool;
+    TreeSink* sink;
+    size_t rotationCount = 0;
+
+    // Root-to-node path of the current operation, reused between calls
+    std::vector<Node*> path;
+
+    // Set when a change skipped the size bookkeeping (BST's append fast
+    // path); the next order-statistics query recounts in O(n)
+    bool sizesStale = false;
+
+    explicit TreeBase(TreeSink* s) : sink(s) {}
+
+    Node* newNode(int value) {
+        int slot;
+        Node* node = pool.acquire(slot);
+        node->data = value;
+        node->id = slot;
+        return node;
+    }
+
+    // Drops every node in O(1); ids start over from 0
+    void resetNodes() {
+        pool.reset();
+        root = nullptr;
+        rightmost = nullptr;
+        sizesStale = false;
+    }
+
+    static int getHeight(Node* N) {
+        if (N == nullptr) return 0;
+        return N->height;
+    }
+
+    static int max(int a, int b) {
+        return (a > b) ? a : b;
+    }
+
+    static int sizeOf(const Node* N) {
+        return N ? N->size : 0;
+    }
+
+    // Helper to recompute height and size from the children
+    static void refresh(Node* N) {
+        N->height = max(getHeight(N->left), getHeight(N->right)) + 1;
+        N->size = sizeOf(N->left) + sizeOf(N->right) + 1;
+    }
+
+    // Sizes for the whole tree, bottom-up with an explicit stack
+    void recountSizes() {
+        std::vector<std::pair<Node*, bool>> stack; // (node, children done)
+        if (root) stack.push_back({root, false});
+        while (!stack.empty()) {
+            auto [node, done] = stack.back();
+            stack.pop_back();
+            if (done) {
+                node->size = sizeOf(node->left) + sizeOf(node->right) + 1;
+                continue;
+            }
+            stack.push_back({node, true});
+            if (node->left) stack.push_back({node->left, false});
+            if (node->right) stack.push_back({node->right, false});
+        }
+        sizesStale = false;
+    }
+
+    // Helper to point whatever held oldChild (parent link or root) at newChild
+    void replaceChild(Node* parent, Node* oldChild, Node* newChild) {
+        if (!parent) root = newChild;
+        else if (parent->left == oldChild) parent->left = newChild;
+        else parent->right = newChild;
+    }
+
+    void setTag(Node* node, int tag) {
+        if (node->tag == tag) return;
+        node->tag = tag;
+        if constexpr (Trace::coarse) sink->onTagChanged(node->id, tag);
+    }
+
+    // New leaf under parent (nullptr = the tree was empty); path holds the
+    // leaf's ancestors
+    Node* attachLeaf(Node* parent, bool right, int value) {
+        for (Node* n : path) n->size++;
+        Node* leaf = newNode(value);
+        if constexpr (Trace::coarse) sink->onNodeAdded(leaf->id, value, parent ? parent->id : -1, right);
+        if (!parent) root = leaf;
+        else if (right) parent->right = leaf;
+        else parent->left = leaf;
+
+        if (!parent || (parent == rightmost && right)) rightmost = leaf;
+        return leaf;
+    }
+
+    // Unlinks node (at most one child) from parent; its child takes its
+    // place. path holds node's ancestors.
+    void splice(Node* parent, Node* node) {
+        for (Node* n : path) n->size--;
+        Node* child = node->left ? node->left : node->right;
+        if constexpr (Trace::coarse) sink->onNodeRemoved(node->id);
+        replaceChild(parent, node, child);
+
+        // The largest key has no right child, so it is always spliced here
+        if (node == rightmost) {
+            rightmost = child ? child : parent;
+            while (rightmost && rightmost->right) rightmost = rightmost->right;
+        }
+        pool.release(node->id);
+    }
+
+    // After a rebuild the largest key is found again down the right spine
+    void findRightmost() {
+        rightmost = root;
+        while (rightmost && rightmost->right) rightmost = rightmost->right;
+    }
+
+    // Rotations return the new subtree root; the caller relinks it under the
+    // old parent. Sizes and AVL heights are refreshed (the other engines
+    // ignore heights).
+    Node* rightRotate(Node* y) {
+        // Highlight nodes involved
+        if constexpr (Trace::full) sink->onRotate(y->id, y->left->id, true);
+
+        Node* x = y->left;
+        Node* T2 = x->right;
+
+        // Perform rotation
+        x->right = y;
+        y->left = T2;
+
+        // Update heights and sizes
+        refresh(y);
+        refresh(x);
+
+        rotationCount++;
+        if constexpr (Trace::coarse) sink->onRotated(y->id, true);
+        if constexpr (Trace::full) sink->onStep("Rotated");
+
+        return x;
+    }
+
+    Node* leftRotate(Node* x) {
+        // Highlight nodes involved
+        if constexpr (Trace::full) sink->onRotate(x->id, x->right->id, false);
+
+        Node* y = x->right;
+        Node* T2 = y->left;
+
+        // Perform rotation
+        y->left = x;
+        x->right = T2;
+
+        // Update heights and sizes
+        refresh(x);
+        refresh(y);
+
+        rotationCount++;
+        if constexpr (Trace::coarse) sink->onRotated(x->id, false);
+        if constexpr (Trace::full) sink->onStep("Rotated");
+
+        return y;
+    }
+
+    // Helper to rotate child above its parent and relink it under grand
+    void rotateUp(Node* child, Node* parent, Node* grand) {
+        Node* top = parent->left == child ? rightRotate(parent) : leftRotate(parent);
+        replaceChild(grand, parent, top);
+    }
+
+    // Morris traversal: no stack at all, however deep the tree. Each node's
+    // in-order predecessor briefly points its right link back at the node as
+    // a thread, and the thread is removed on the second visit, so the tree is
+    // unchanged afterwards.
+    static void inorderExtraction(Node* node, std::vector<int>& nodes) {
+        while (node) {
+            if (!node->left) {
+                nodes.push_back(node->data);
+                node = node->right;
+                continue;
+            }
+            Node* pred = node->left;
+            while (pred->right && pred->right != node) pred = pred->right;
+            if (!pred->right) {
+                pred->right = node; // thread back, then go left
+                node = node->left;
+            } else {
+                pred->right = nullptr; // left subtree done
+                nodes.push_back(node->data);
+                node = node->right;
+            }
+        }
+    }
+
+    // Current keys merged with values (sorted, deduplicated); existing gets
+    // the number of keys already in the tree
+    std::vector<int> mergeKeys(const int* values, size_t n, size_t& existing) const {
+        std::vector<int> keys;
+        inorderExtraction(root, keys);
+        existing = keys.size();
+
+        std::vector<int> incoming(values, values + n);
+        std::sort(incoming.begin(), incoming.end());
+        incoming.erase(std::unique(incoming.begin(), incoming.end()), incoming.end());
+
+        std::vector<int> merged;
+        merged.reserve(existing + incoming.size());
+        std::set_union(keys.begin(), keys.end(), incoming.begin(), incoming.end(), std::back_inserter(merged));
+        return merged;
+    }
+
+    // Perfectly balanced subtree over sorted[lo, hi), nodes created in pre-order
+    // so each delta's parent already exists. Heights (valid for AVL) and sizes
+    // are set.
+    Node* buildBalanced(const std::vector<int>& sorted, int lo, int hi, int parentId, bool right) {
+        if (lo >= hi) return nullptr;
+        int mid = lo + (hi - lo) / 2;
+
+        Node* node = newNode(sorted[mid]);
+        if constexpr (Trace::coarse) sink->onNodeAdded(node->id, node->data, parentId, right);
+
+        node->left = buildBalanced(sorted, lo, mid, node->id, false);
+        node->right = buildBalanced(sorted, mid + 1, hi, node->id, true);
+        refresh(node);
+        return node;
+    }
+
+    // Replaces the whole tree with a balanced one over sorted (one reset
+    // delta, then the adds)
+    void rebuildFrom(const std::vector<int>& sorted) {
+        resetNodes();
+        if constexpr (Trace::coarse) sink->onReset();
+        root = buildBalanced(sorted, 0, static_cast<int>(sorted.size()), -1, false);
+        findRightmost();
+    }
+
+    bool searchPath(int value, std::vector<int>& visited) const {
+        Node* cur = root;
+        while (cur) {
+            visited.push_back(cur->id);
+            if (cur->data == value) return true;
+            cur = value < cur->data ? cur->left : cur->right;
+        }
+        return false;
+    }
+
+    // Keys < value (or <= value with inclusive), collecting the ids on the
+    // way in visited if given
+    size_t rankOf(int value, bool inclusive, std::vector<int>* visited = nullptr) {
+        if (sizesStale) recountSizes();
+        size_t rank = 0;
+        Node* cur = root;
+        while (cur) {
+            if (visited) visited->push_back(cur->id);
+            if (value < cur->data || (value == cur->data && !inclusive)) {
+                cur = cur->left;
+            } else {
+                rank += sizeOf(cur->left) + 1;
+                cur = cur->right;
+            }
+        }
+        return rank;
+    }
+
+public:
+    TreeBase(const TreeBase&) = delete;
+    TreeBase& operator=(const TreeBase&) = delete;
+
+    // Returns true if value is in the tree; the visited path goes to the sink
+    bool search(int value) {
+        if constexpr (Trace::coarse) {
+            std::vector<int> visited;
+            bool found = searchPath(value, visited);
+            sink->onSearchPath(visited);
+            return found;
+        } else {
+            Node* cur = root;
+            while (cur && cur->data != value) {
+                cur = value < cur->data ? cur->left : cur->right;
+            }
+            return cur != nullptr;
+        }
+    }
+
+    // O(1): the pool forgets every node and keeps its slabs for the next fill
+    void clear() {
+        resetNodes();
+        if constexpr (Trace::coarse) {
+            sink->onReset();
+            sink->onCommit(root, "Tree Cleared");
+        }
+    }
+
+    // --- Order statistics ---
+    // O(depth) through Node::size. rank and select report their walk to the
+    // sink like search; none of them change the tree (splay included).
+
+    // Number of keys smaller than value
+    size_t rank(int value) {
+        if constexpr (Trace::coarse) {
+            std::vector<int> visited;
+            size_t r = rankOf(value, false, &visited);
+            sink->onSearchPath(visited);
+            return r;
+        } else {
+            return rankOf(value, false);
+        }
+    }
+
+    // The index-th smallest key (from 0) into key; false if out of range
+    bool select(size_t index, int& key) {
+        if (sizesStale) recountSizes();
+        std::vector<int> visited;
+        Node* cur = root;
+        while (cur) {
+            if constexpr (Trace::coarse) visited.push_back(cur->id);
+            size_t left = sizeOf(cur->left);
+            if (index == left) break;
+            if (index < left) {
+                cur = cur->left;
+            } else {
+                index -= left + 1;
+                cur = cur->right;
+            }
+        }
+        if constexpr (Trace::coarse) sink->onSearchPath(visited);
+        if (!cur) return false;
+        key = cur->data;
+        return true;
+    }
+
+    // Number of keys in [lo, hi]
+    size_t countRange(int lo, int hi) {
+        if (lo > hi) return 0;
+        return rankOf(hi, true) - rankOf(lo, false);
+    }
+
+    // Appends the keys in [lo, hi] to out in order: an in-order walk that
+    // skips the subtrees outside the range, O(depth + matches)
+    void rangeScan(int lo, int hi, std::vector<int>& out) const {
+        std::vector<const Node*> stack;
+        const Node* cur = root;
+        while (cur || !stack.empty()) {
+            // Down the left side, stepping right past keys below lo
+            while (cur) {
+                if (cur->data < lo) {
+                    cur = cur->right;
+                } else {
+                    stack.push_back(cur);
+                    cur = cur->left;
+                }
+            }
+            if (stack.empty()) break;
+            const Node* node = stack.back();
+            stack.pop_back();
+            if (node->data > hi) break;
+            out.push_back(node->data);
+            cur = node->right;
+        }
+    }
+
+    // Keys in sorted order
+    std::vector<int> keys() const {
+        std::vector<int> out;
+        inorderExtraction(root, out);
+        return out;
+    }
+
+    const Node* getRoot() const { return root; }
+
+    // Rotations performed since construction (all operations, all kinds)
+    size_t rotations() const { return rotationCount; }
+
+    // Node memory: live nodes, slots handed out, bytes held by the pool
+    size_t liveNodes() const { return pool.liveCount(); }
+    size_t nodeSlots() const { return pool.slotCount(); }
+    size_t reservedBytes() const { return pool.reservedBytes(); }
+};
+
+// Plain BST, or AVL once setAVL(true) is called
+template <class Trace>
+class BST : public TreeBase<Trace> {
+private:
+    using Base = TreeBase<Trace>;
+    using Base::root;
+    using Base::rightmost;
+    using Base::sink;
+    using Base::path;
+    using Base::getHeight;
+    using Base::max;
+    using Base::replaceChild;
+    using Base::rightRotate;
+    using Base::leftRotate;
+    using Base::inorderExtraction;
+
+    bool useAVL = false;
+
+    // --- AVL Helpers ---
+    static int getBalance(Node* N) {
+        if (N == nullptr) return 0;
+        return getHeight(N->left) - getHeight(N->right);
+    }
+
+    void rebuildBalanced() {
+        std::vector<int> sorted;
+        inorderExtraction(root, sorted);
+        this->rebuildFrom(sorted);
+    }
+
+    // --- Day-Stout-Warren ---
+    // Both phases work below a pseudo-root (a stack Node that never reaches
+    // the sink), so rotating the real root needs no special case.
+
+    // Right rotations until no node has a left child; returns the node count
+    int treeToVine(Node* pseudo) {
+        int count = 0;
+        Node* tail = pseudo;
+        Node* rest = tail->right;
+        while (rest) {
+            if (rest->left) {
+                Node* up = rest->left;
+                rest->left = up->right;
+                up->right = rest;
+                tail->right = up;
+                this->rotationCount++;
+                if constexpr (Trace::coarse) sink->onRotated(rest->id, true);
+                rest = up;
+            } else {
+                count++;
+                tail = rest;
+                rest = rest->right;
+            }
+        }
+        return count;
+    }
+
+    // Left-rotates every other node of the top `count` on the vine
+    void compress(Node* pseudo, int count) {
+        Node* scanner = pseudo;
+        for (int i = 0; i < count; i++) {
+            Node* child = scanner->right;
+            scanner->right = child->right;
+            scanner = scanner->right;
+            child->right = scanner->left;
+            scanner->left = child;
+            this->rotationCount++;
+            if constexpr (Trace::coarse) sink->onRotated(child->id, false);
+        }
+    }
+
+    // The vine rotations above skip the bookkeeping; this restores heights
+    // and sizes once the tree is balanced
+    static void fixHeights(Node* node) {
+        if (!node) return;
+        fixHeights(node->left);
+        fixHeights(node->right);
+        Base::refresh(node);
+    }
+
+    void dayStoutWarren() {
+        Node pseudo;
+        pseudo.right = root;
+
+        int n = treeToVine(&pseudo);
+        if constexpr (Trace::full) sink->onStep("Flattened to a vine");
+
+        // Leaves of the bottom level first, then halve until balanced
+        int full = 1;
+        while (full * 2 + 1 <= n) full = full * 2 + 1;
+        compress(&pseudo, n - full);
+        if constexpr (Trace::full) sink->onStep("Compressing");
+        while (full > 1) {
+            full /= 2;
+            compress(&pseudo, full);
+            if constexpr (Trace::full) sink->onStep("Compressing");
+        }
+
+        root = pseudo.right;
+        fixHeights(root); // depth is O(log n) now
+        this->sizesStale = false;
+    }
+
+    // --- BST Operations ---
+
+    // Restores the AVL property at node (its subtrees are valid AVL trees)
+    // and returns the new subtree root. The child's balance picks single vs
+    // double rotation; this covers the insert and delete cases alike.
+    Node* balanceNode(Node* node) {
+        node->height = 1 + max(getHeight(node->left), getHeight(node->right));
+        int balance = getBalance(node);
+
+        if (balance > 1) {
+            // Left Right Case
+            if (getBalance(node->left) < 0) node->left = leftRotate(node->left);
+            // Left Left Case
+            return rightRotate(node);
+        }
+        if (balance < -1) {
+            // Right Left Case
+            if (getBalance(node->right) > 0) node->right = rightRotate(node->right);
+            // Right Right Case
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    // Walks path bottom-up, rebalancing each node and relinking it under its
+    // parent. Inserts can stop at the first node whose height is unchanged:
+    // nothing above it moves. Removes may need a rotation at every level.
+    void retrace(bool stopWhenSettled) {
+        for (size_t i = path.size(); i-- > 0;) {
+            Node* node = path[i];
+            int before = node->height;
+            Node* top = balanceNode(node);
+            if (top != node) replaceChild(i > 0 ? path[i - 1] : nullptr, node, top);
+            if (stopWhenSettled && top->height == before) break;
+        }
+    }
+
+    // Iterative, so a degenerate plain-BST chain can be any length
+    void insertNode(int value) {
+        path.clear();
+        Node* parent = nullptr;
+        Node* cur = root;
+        bool right = false;
+
+        // Sorted input keeps landing past the largest key; go there directly.
+        // Its ancestors (the right spine) aren't on path, so sizes go stale.
+        if (!useAVL && rightmost && value > rightmost->data) {
+            parent = rightmost;
+            cur = nullptr;
+            right = true;
+            this->sizesStale = true;
+        }
+
+        while (cur) {
+            if (value == cur->data) return; // Duplicate keys not allowed
+            path.push_back(cur);
+            parent = cur;
+            right = value > cur->data;
+            cur = right ? cur->right : cur->left;
+        }
+
+        this->attachLeaf(parent, right, value);
+        if (useAVL) retrace(true);
+    }
+
+    void removeNode(int value) {
+        path.clear();
+        Node* node = root;
+        while (node && node->data != value) {
+            path.push_back(node);
+            node = value < node->data ? node->left : node->right;
+        }
+        if (!node) return;
+
+        // Two children: take the successor's value, then splice the successor
+        if (node->left && node->right) {
+            path.push_back(node);
+            Node* succ = node->right;
+            while (succ->left) {
+                path.push_back(succ);
+                succ = succ->left;
+            }
+            node->data = succ->data;
+            if constexpr (Trace::coarse) sink->onValueChanged(node->id, node->data);
+            node = succ;
+        }
+
+        this->splice(path.empty() ? nullptr : path.back(), node);
+        if (useAVL) retrace(false);
+    }
+
+public:
+    explicit BST(TreeSink* s = &nullTreeSink) : Base(s) {}
+
+    // Turning AVL on rebalances whatever is there first
+    void setAVL(bool enable, RebalanceMode mode = RebalanceMode::Rebuild) {
+        useAVL = enable;
+        if (useAVL) rebalance(mode);
+    }
+
+    // Balanced tree over the same keys in O(n); heights are valid for AVL
+    void rebalance(RebalanceMode mode = RebalanceMode::Rebuild) {
+        if (mode == RebalanceMode::DSW) dayStoutWarren();
+        else rebuildBalanced();
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Rebalanced");
+    }
+
+    void insert(int value) {
+        insertNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    // Inserts n values and renders once: the existing keys and the new ones are
+    // merged in sorted order and the tree is rebuilt balanced in O(n).
+    // Returns how many keys were new.
+    int insertBulk(const int* values, size_t n) {
+        size_t existing;
+        std::vector<int> merged = this->mergeKeys(values, n, existing);
+        this->rebuildFrom(merged);
+
+        if constexpr (Trace::coarse) sink->onCommit(root, "Bulk Loaded");
+        return static_cast<int>(merged.size() - existing);
+    }
+
+    void remove(int value) {
+        removeNode(value);
+        if constexpr (Trace::coarse) sink->onCommit(root, "Tree Updated");
+    }
+
+    bool avl() const { return useAVL; }
+};
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <climits>
+
+// --- Tidy tree layout ---
+// Reingold-Tilford, the layout d3.tree() draws: every node centered over its
+// children, and each subtree pushed right against its left neighbours until
+// they are a node apart (siblings) or two (cousins) at every level.
+//
+// A subtree's shape only depends on what is inside it, so each node keeps
+// the result for its subtree: its children's x offsets and the subtree's
+// left and right contours (the outermost x on each level). An edit marks the
+// nodes it touched and their ancestors, and update() redoes only those,
+// bottom-up, reusing every untouched subtree as-is. Merging two subtrees
+// costs the height of the shorter one (the contours are shared linked lists,
+// so the taller side's deeper levels are reused, not copied), which makes a
+// full layout O(n) and an insert, removal or rotation O(depth) merges.
+//
+// Nodes are keyed by the engine's ids. Children are ordered by slot: 0 and 1
+// for left / right in a binary tree, 0 .. arity - 1 in an implicit d-ary
+// heap. Coordinates are in pixels, root at (0, 0), y growing by levelHeight
+// per level; x is kept on a half-node grid so every position is exact.
+class TreeLayout {
+public:
+    static constexpr int NONE = -1;
+
+private:
+    // Gaps between neighbours on a level, in half node widths
+    static constexpr int SIBLING_GAP = 2;
+    static constexpr int COUSIN_GAP = 4;
+
+    struct LayoutNode {
+        int parent, firstChild, nextSibling;
+        int slot;
+        int offset;              // x relative to the parent (half widths)
+        int leftHead, rightHead; // contours, starting at this node
+        int height;              // levels in the subtree
+        int x, depth;            // position from the last update
+        bool present, dirty, touched;
+    };
+
+    // One level of a contour: x change from the level above, and the next level
+    struct Link {
+        int dx;
+        int next;
+    };
+
+    // A contour list plus the x of its first level
+    struct Contour {
+        int head;
+        int x;
+        int length;
+    };
+
+    std::vector<LayoutNode> nodes; // by id
+    std::vector<Link> links;
+    std::vector<int> moved;
+    std::vector<int> order, stack; // scratch
+    int root = NONE;
+    size_t count = 0;
+    int nodeWidth;
+    int levelHeight;
+
+    int newLink(int dx, int next) {
+        links.push_back({dx, next});
+        return static_cast<int>(links.size()) - 1;
+    }
+
+    // Marks v for relayout, and its ancestors up to the first one already marked
+    void markDirty(int v) {
+        nodes[v].dirty = true;
+        for (int p = nodes[v].parent; p != NONE && !nodes[p].dirty; p = nodes[p].parent) nodes[p].dirty = true;
+    }
+
+    void unlink(int c) {
+        int p = nodes[c].parent;
+        if (p == NONE) return;
+        int* at = &nodes[p].firstChild;
+        while (*at != c) at = &nodes[*at].nextSibling;
+        *at = nodes[c].nextSibling;
+        nodes[c].parent = NONE;
+    }
+
+    // Hangs c under p at slot, keeping p's children in slot order
+    void link(int p, int c, int slot) {
+        nodes[c].parent = p;
+        nodes[c].slot = slot;
+        int* at = &nodes[p].firstChild;
+        while (*at != NONE && nodes[*at].slot < slot) at = &nodes[*at].nextSibling;
+        nodes[c].nextSibling = *at;
+        *at = c;
+    }
+
+    // Puts replacement (may be NONE) where v was: same parent, same slot
+    void replace(int v, int replacement) {
+        int p = nodes[v].parent, slot = nodes[v].slot;
+        unlink(v);
+        if (replacement != NONE) unlink(replacement);
+        if (p == NONE) {
+            root = replacement;
+            if (replacement != NONE) nodes[replacement].parent = NONE;
+        } else {
+            if (replacement != NONE) link(p, replacement, slot);
+            markDirty(p);
+        }
+    }
+
+    int childAt(int v, int slot) const {
+        for (int c = nodes[v].firstChild; c != NONE; c = nodes[c].nextSibling) {
+            if (nodes[c].slot == slot) return c;
+        }
+        return NONE;
+    }
+
+    // Smallest x for b's first level that keeps it clear of a on every level both have
+    int separation(Contour a, Contour b) const {
+        int sep = INT_MIN, xa = a.x, xb = b.x;
+        for (int ia = a.head, ib = b.head, gap = SIBLING_GAP;; gap = COUSIN_GAP) {
+            if (xa - xb + gap > sep) sep = xa - xb + gap;
+            ia = links[ia].next;
+            ib = links[ib].next;
+            if (ia == NONE || ib == NONE) return sep;
+            xa += links[ia].dx;
+            xb += links[ib].dx;
+        }
+    }
+
+    // top's levels, then bottom's below them. Copies top when bottom is
+    // taller (so top is the shorter one) and shares bottom's tail.
+    Contour extend(Contour top, Contour bottom) {
+        if (bottom.length <= top.length) return top;
+        int head = newLink(0, NONE), last = head;
+        int it = top.head, xt = top.x;
+        for (int d = 1; d < top.length; d++) {
+            it = links[it].next;
+            xt += links[it].dx;
+            int copy = newLink(links[it].dx, NONE);
+            links[last].next = copy;
+            last = copy;
+        }
+        int ib = bottom.head, xb = bottom.x;
+        for (int d = 1; d <= top.length; d++) {
+            ib = links[ib].next;
+            xb += links[ib].dx;
+        }
+        int join = newLink(xb - xt, links[ib].next);
+        links[last].next = join;
+        return {head, top.x, bottom.length};
+    }
+
+    // Node's own contour: itself at 0, then c shifted by shift
+    int prepend(Contour c, int shift) {
+        return newLink(0, newLink(c.x + shift, links[c.head].next));
+    }
+
+    // Places v's children (already laid out) left to right and centers v
+    void layoutNode(int v) {
+        int first = nodes[v].firstChild;
+        if (first == NONE) {
+            nodes[v].leftHead = nodes[v].rightHead = newLink(0, NONE);
+            nodes[v].height = 1;
+            return;
+        }
+
+        Contour left{nodes[first].leftHead, 0, nodes[first].height};
+        Contour right{nodes[first].rightHead, 0, nodes[first].height};
+        nodes[first].offset = 0;
+        int last = 0;
+        for (int c = nodes[first].nextSibling; c != NONE; c = nodes[c].nextSibling) {
+            Contour cl{nodes[c].leftHead, 0, nodes[c].height};
+            int pos = separation(right, cl);
+            pos += pos & 1; // whole node widths, so the center stays on the grid
+            nodes[c].offset = last = pos;
+            cl.x = pos;
+            left = extend(left, cl);
+            right = extend({nodes[c].rightHead, pos, nodes[c].height}, right);
+        }
+
+        int center = last / 2;
+        for (int c = first; c != NONE; c = nodes[c].nextSibling) nodes[c].offset -= center;
+        nodes[v].leftHead = prepend(left, -center);
+        nodes[v].rightHead = prepend(right, -center);
+        nodes[v].height = left.length + 1;
+    }
+
+public:
+    TreeLayout(int nodeWidth, int levelHeight) : nodeWidth(nodeWidth), levelHeight(levelHeight) {}
+
+    // New leaf under parentId (-1 for the root) at slot
+    void add(int id, int parentId, int slot) {
+        if (static_cast<size_t>(id) >= nodes.size()) nodes.resize(id + 1);
+        nodes[id] = {NONE, NONE, NONE, 0, 0, NONE, NONE, 0, INT_MIN, -1, true, false, false};
+        count++;
+        if (parentId < 0) root = id;
+        else link(parentId, id, slot);
+        markDirty(id);
+    }
+
+    // Splices out a node with at most one child; the child takes its place
+    void remove(int id) {
+        replace(id, nodes[id].firstChild);
+        nodes[id].present = false;
+        count--;
+    }
+
+    // Binary rotation around pivotId (right = its slot-0 child moves up)
+    void rotate(int pivotId, bool right) {
+        int up = childAt(pivotId, right ? 0 : 1);
+        int inner = childAt(up, right ? 1 : 0);
+        if (inner != NONE) unlink(inner);
+        replace(pivotId, up);
+        link(up, pivotId, right ? 1 : 0);
+        if (inner != NONE) link(pivotId, inner, right ? 0 : 1);
+        markDirty(pivotId);
+    }
+
+    void clear() {
+        nodes.clear();
+        links.clear();
+        root = NONE;
+        count = 0;
+    }
+
+    // Lays out whatever changed since the last call; returns the ids whose
+    // position moved (new nodes included), valid until the next call
+    const std::vector<int>& update() {
+        moved.clear();
+        if (root == NONE) return moved;
+
+        // Contours of replaced layouts pile up in the arena; past a few per
+        // node, start it over and lay everything out again
+        if (links.size() > 8 * count + 1024) {
+            links.clear();
+            for (auto& n : nodes) n.dirty = n.present;
+        }
+
+        // Marked nodes, parents first; laid out in reverse so children go first
+        order.clear();
+        stack.assign(1, root);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            if (!nodes[v].dirty) continue;
+            order.push_back(v);
+            for (int c = nodes[v].firstChild; c != NONE; c = nodes[c].nextSibling) stack.push_back(c);
+        }
+        for (size_t i = order.size(); i-- > 0;) {
+            layoutNode(order[i]);
+            nodes[order[i]].dirty = false;
+            nodes[order[i]].touched = true;
+        }
+
+        // Absolute positions. Below a node that neither moved nor was laid
+        // out again nothing can have moved, so the walk stops there.
+        stack.assign(1, root);
+        nodes[root].offset = 0;
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            LayoutNode& n = nodes[v];
+            int p = n.parent;
+            int x = p == NONE ? 0 : nodes[p].x + n.offset;
+            int depth = p == NONE ? 0 : nodes[p].depth + 1;
+            bool changed = x != n.x || depth != n.depth;
+            if (changed) {
+                n.x = x;
+                n.depth = depth;
+                moved.push_back(v);
+            }
+            if (changed || n.touched) {
+                for (int c = n.firstChild; c != NONE; c = nodes[c].nextSibling) stack.push_back(c);
+            }
+            n.touched = false;
+        }
+        return moved;
+    }
+
+    // Pixel position from the last update
+    int x(int id) const { return nodes[id].x * nodeWidth / 2; }
+    int y(int id) const { return nodes[id].depth * levelHeight; }
+
+    // Calls f(id) for every node, in no particular order
+    template <class F>
+    void forEachNode(F f) const {
+        for (size_t id = 0; id < nodes.size(); id++) {
+            if (nodes[id].present) f(static_cast<int>(id));
+        }
+    }
+
+    size_t size() const { return count; }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// --- Version events ---
+// Shared by the persistent engines (persistent_tree.h, persistent_heap.h).
+// A version is only ever shown whole, so there are no deltas: the viewer
+// asks the engine to walk the version it is told about.
+class VersionSink {
+public:
+    virtual ~VersionSink() = default;
+
+    // version is now the one shown, after an edit (a new version) or a checkout
+    virtual void onVersion(int version, const char* message) {}
+    // Node ids from the root down, in the shown version
+    virtual void onSearchPath(const std::vector<int>& ids) {}
+};
+
+inline VersionSink nullVersionSink;
+
+// Node arena and version list for a path-copying structure. Nodes are
+// append-only and never change once written, so every version is just a
+// root index and they all share whatever an edit didn't touch: an edit
+// copies the nodes on its path (O(log n) of them for balanced shapes) and
+// the rest of the tree is reused as-is.
+//
+// Versions are numbered from 0 (empty). Editing while an older version is
+// shown branches from it and drops the versions after it. Their nodes were
+// all appended after it was made, so truncating the arena gets them back.
+template <class NodeT>
+class VersionHistory {
+public:
+    static constexpr int NONE = -1;
+
+private:
+    struct Version {
+        int root;
+        size_t nodesEnd; // arena size right after this version was made
+    };
+
+    std::vector<NodeT> nodes;
+    std::vector<Version> versions{{NONE, 0}};
+    int shown = 0;
+
+public:
+    // Appends a node; the reference from at() is invalidated by the next add
+    int add(const NodeT& node) {
+        nodes.push_back(node);
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    const NodeT& at(int index) const { return nodes[index]; }
+
+    // Call before the first add of an edit: forgets the versions after the
+    // shown one along with their nodes
+    void beginEdit() {
+        versions.resize(shown + 1);
+        nodes.resize(versions.back().nodesEnd);
+    }
+
+    // Makes root the newest version and shows it
+    int commit(int root) {
+        versions.push_back({root, nodes.size()});
+        shown = static_cast<int>(versions.size()) - 1;
+        return shown;
+    }
+
+    // false if there is no such version
+    bool checkout(int version) {
+        if (version < 0 || version >= count()) return false;
+        shown = version;
+        return true;
+    }
+
+    void clear() {
+        nodes.clear();
+        versions.assign(1, {NONE, 0});
+        shown = 0;
+    }
+
+    int root() const { return versions[shown].root; }
+    int root(int version) const { return versions[version].root; }
+    int current() const { return shown; }
+    int count() const { return static_cast<int>(versions.size()); }
+
+    // Nodes across every version, and the bytes holding them
+    size_t nodeCount() const { return nodes.size(); }
+    size_t reservedBytes() const {
+        return nodes.capacity() * sizeof(NodeT) + versions.capacity() * sizeof(Version);
+    }
+};